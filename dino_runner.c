@@ -3,126 +3,191 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-#include <time.h>
-#include "pico/stdlib.h"
-#include "pico/binary_info.h"
-#include "hardware/pio.h"
-#include "hardware/clocks.h"
-#include "hardware/i2c.h"
 
+#include "inc/hal.h"     // Camada de abstração de hardware (Pico ou host)
 #include "inc/ssd1306.h" // Biblioteca para controlar o display
-#include "ws2818b.pio.h" // Programa PIO para controlar os LEDs RGB
+#include "inc/np_color.h" // Tabelas de gama/brilho dos LEDs
+#include "inc/np_geometry.h" // Geometria da matriz de LEDs
+#include "inc/np_lanes.h" // Saída paralela em várias fitas
+#include "inc/sprite.h"   // Sprites em máscara de bits
+#include "inc/tick.h"     // Relógio de passo fixo
+#include "inc/spsc.h"     // Fila sem trava entre os núcleos
+#include "inc/input.h"    // Botões por interrupção
+#include "inc/prof.h"     // Perfilador por etapa
+#include "inc/replay.h"   // Gravação/reprodução de partidas
+#include "inc/obstaculos.h" // Pool de obstáculos e gerador de padrões
+#include "inc/jogo.h"     // Passo lógico do jogo (estado + entradas)
+#include "inc/oled_mundo.h" // Visão do jogo em resolução cheia no OLED
+#include "inc/recordes.h" // Recordes e estatísticas na flash
+#include "inc/telemetria.h" // Telemetria binária pela serial
 
 // Função auxiliar: retorna o maior valor entre a e b
 #define max(a, b) ((a) > (b) ? (a) : (b))
 
-// Quantidade de LEDs na matriz (5x5 = 25)
-#define LED_COUNT 25
-// Pino onde a fita/matriz de LEDs está conectada
+// Quantidade de LEDs na matriz (geometria em inc/np_geometry.h; padrão 5x5)
+#define LED_COUNT NP_LED_COUNT
+// Pino onde a fita/matriz de LEDs está conectada (com NP_LANES > 1, a fita k
+// fica no pino LED_PIN + k)
+#ifndef LED_PIN
 #define LED_PIN 7
-// Fator de brilho: 0.3f = 30% da intensidade
-#define LED_BRIGHTNESS 0.3f
+#endif
+#if LED_PIN < 14 && LED_PIN + NP_LANES > 14
+#error "As fitas de LEDs chegariam aos pinos do OLED (14 e 15): mude LED_PIN"
+#endif
+
+// Paleta de cores dos sprites (R, G, B); o índice 0 é o LED apagado
+enum
+{
+  COR_APAGADO,
+  COR_DINO,
+  COR_INIMIGO,
+  COR_INIMIGO_RAPIDO,
+};
+
+const uint8_t paleta[][3] = {
+    [COR_APAGADO] = {0, 0, 0},
+    [COR_DINO] = {0, 0, 255},
+    [COR_INIMIGO] = {255, 0, 0},
+    [COR_INIMIGO_RAPIDO] = {255, 128, 0},
+};
+
+// Dificuldade: 0 = um inimigo por vez (jogo original), 1 = padrões com vários
+// inimigos e inimigos rápidos (tabelas em inc/jogo.c)
+#ifndef DINO_DIFICULDADE
+#define DINO_DIFICULDADE 0
+#endif
+
+// OLED: 0 = só o placar, 1 = o jogo inteiro em 128x64 (inc/oled_mundo.h), com
+// o chão rolado pelo próprio display
+#ifndef DINO_OLED_MUNDO
+#define DINO_OLED_MUNDO 0
+#endif
+
+// Clock do I2C do OLED: 1 = tenta o Fast-mode Plus (1 MHz), mantendo os
+// 400 kHz se o display não responder nessa velocidade
+#ifndef DINO_OLED_FMPLUS
+#define DINO_OLED_FMPLUS 0
+#endif
+
+// Painel de estatísticas: 1 = um segundo OLED (128x32) no i2c0 com os
+// contadores de ticks e frames, atualizado pelo renderizador em paralelo com o
+// placar (cada display tem o seu barramento e o seu DMA)
+#ifndef DINO_OLED_PAINEL
+#define DINO_OLED_PAINEL 0
+#endif
+
+// Telemetria: 1 = envia pela USB, em pacotes binários, o estado de cada tick,
+// os frames dos LEDs e as janelas do OLED (inc/telemetria.h), para ver e
+// gravar a partida com tools/dino_telemetria.c. Os pacotes dividem a USB com
+// o texto do stdio, que só é escrito entre quadros (texto_liberado)
+#ifndef DINO_TELEMETRIA
+#define DINO_TELEMETRIA 0
+#endif
+
+// Tempo máximo esperando a telemetria pendente sair no Game Over (us)
+#define TELEMETRIA_FIM_US 200000
 
 // Pinos dos botões
 #define BUTTON_PIN 5  // Botão de pulo
 #define BUTTON_PIN2 6 // Botão de abaixar
 
+// Intervalo entre os resumos do perfilador no stdio (ms de jogo)
+#define PROF_INTERVALO_MS 5000
+
 // Pinos I2C para o display (SSD1306)
 const uint I2C_SDA = 14;
 const uint I2C_SCL = 15;
 
-// Estrutura de cada LED: compõe-se de valores G, R, B
-struct pixel_t
-{
-  uint8_t G, R, B;
-};
-// Alias para pixel_t
-typedef struct pixel_t pixel_t;
-typedef pixel_t npLED_t;
+// Pinos I2C do painel de estatísticas (DINO_OLED_PAINEL)
+const uint I2C_PAINEL_SDA = 0;
+const uint I2C_PAINEL_SCL = 1;
 
-// Array global que representa nosso buffer de LEDs
-npLED_t leds[LED_COUNT];
+// Intervalo entre as atualizações do painel de estatísticas (us)
+#define PAINEL_INTERVALO_US 500000
 
-// Variáveis para trabalhar com PIO
-PIO np_pio;
-uint sm;
+// Cada LED é uma palavra de 32 bits já no formato consumido pela PIO:
+// G nos bits 31..24, R nos bits 23..16 e B nos bits 15..8
+typedef uint32_t npLED_t;
+
+// Array global que representa nosso buffer de LEDs (enviado por DMA)
+npLED_t leds[LED_COUNT];
+#if NP_LANES > 1
+// Com várias fitas, o DMA lê os bits de leds[] já transpostos para a PIO
+uint32_t leds_lanes[NP_LANES_WORDS(NP_LANE_LEDS)];
+#endif
+
+// Intensidade desejada de cada canal (G, R, B) em 8.8, já com gama e brilho
+uint16_t leds_intensidade[LED_COUNT][3];
+// Fração acumulada de cada canal para o pontilhamento temporal
+uint8_t leds_erro[LED_COUNT][3];
+// Tabelas do nível de brilho atual (ver inc/np_color.h)
+const uint16_t (*np_lut)[256] = np_color_lut[NP_BRIGHTNESS_DEFAULT];
 
 //------------------------------------------------------------------------------
-// getIndex: Converte (x,y) em um índice para acessar o array leds[]
-//------------------------------------------------------------------------------
-// Observação: Como a fiação da matriz nem sempre é linear, precisamos de um
-// mapeamento personalizado.
-// Neste caso, se a linha y é par, lemos da esquerda pra direita,
-// se ímpar, da direita pra esquerda. Ajuste se sua ligação for diferente.
+// npSetBrightness: Seleciona um dos NP_BRIGHTNESS_LEVELS níveis de brilho.
+// Vale para os próximos npSetLED.
 //------------------------------------------------------------------------------
-int getIndex(int x, int y)
+void npSetBrightness(uint nivel)
 {
-  if (y % 2 == 0)
-  {
-    return 24 - (y * 5 + x);
-  }
-  else
+  if (nivel < NP_BRIGHTNESS_LEVELS)
   {
-    return 24 - (y * 5 + (4 - x));
+    np_lut = np_color_lut[nivel];
   }
 }
 
 //------------------------------------------------------------------------------
-// npSetLED: Ajusta as cores de um pixel específico do buffer, aplicando o brilho.
+// npSetLED: Ajusta as cores de um pixel específico do buffer, aplicando gama,
+// brilho e balanço de branco por tabela (sem ponto flutuante).
 //------------------------------------------------------------------------------
-void npSetLED(uint index, uint8_t r, uint8_t g, uint8_t b)
+void __not_in_flash_func(npSetLED)(uint index, uint8_t r, uint8_t g, uint8_t b)
 {
-  leds[index].R = (uint8_t)(r * LED_BRIGHTNESS);
-  leds[index].G = (uint8_t)(g * LED_BRIGHTNESS);
-  leds[index].B = (uint8_t)(b * LED_BRIGHTNESS);
+  leds_intensidade[index][NP_CHANNEL_G] = np_lut[NP_CHANNEL_G][g];
+  leds_intensidade[index][NP_CHANNEL_R] = np_lut[NP_CHANNEL_R][r];
+  leds_intensidade[index][NP_CHANNEL_B] = np_lut[NP_CHANNEL_B][b];
 }
 
 //------------------------------------------------------------------------------
-// setLeds: Copia uma matriz 5x5x3 ("sprite") para o buffer de LEDs global.
-// Cada pixel da matriz vira um LED na posição mapeada por getIndex.
+// npWaitDone: Espera o envio anterior (DMA + reset dos WS2812) terminar.
+// Deve ser chamada antes de alterar leds[], que é lido diretamente pelo DMA.
 //------------------------------------------------------------------------------
-void setLeds(int matriz[5][5][3])
+void npWaitDone()
 {
-  for (int linha = 0; linha < 5; linha++)
+  hal_np_wait();
+}
+
+//------------------------------------------------------------------------------
+// setLeds: Expande as camadas de sprites para o buffer de LEDs global.
+// Cada casa do tabuleiro vira os NP_CELL_LEDS LEDs listados em np_board_map
+// (fiação e ampliação já resolvidas em tempo de compilação), com a cor da
+// paleta da camada mais alta que a ocupa.
+//------------------------------------------------------------------------------
+void __not_in_flash_func(setLeds)(const sprite_t *camadas, int n)
+{
+  uint8_t cores[SPRITE_PIXELS];
+  sprite_expande(camadas, n, cores);
+
+  const uint16_t *led = np_board_map;
+  for (int casa = 0; casa < SPRITE_PIXELS; casa++)
   {
-    for (int coluna = 0; coluna < 5; coluna++)
+    const uint8_t *cor = paleta[cores[casa]];
+    for (int k = 0; k < NP_CELL_LEDS; k++)
     {
-      int pos = getIndex(linha, coluna);
-      npSetLED(pos,
-               matriz[coluna][linha][0],
-               matriz[coluna][linha][1],
-               matriz[coluna][linha][2]);
+      npSetLED(*led++, cor[0], cor[1], cor[2]);
     }
   }
 }
 
 //------------------------------------------------------------------------------
-// npInit: Inicializa a PIO para enviar dados aos LEDs do tipo WS2812
+// npInit: Inicializa a saída para os LEDs do tipo WS2812 (PIO no Pico)
 //------------------------------------------------------------------------------
 void npInit(uint pin)
 {
-  // Adiciona programa PIO no pio0
-  uint offset = pio_add_program(pio0, &ws2818b_program);
-  np_pio = pio0;
-
-  // Tenta obter uma state machine livre
-  sm = pio_claim_unused_sm(np_pio, false);
-  if (sm < 0)
-  {
-    // Se não houver, tentamos o pio1
-    np_pio = pio1;
-    sm = pio_claim_unused_sm(np_pio, true);
-  }
-
-  // Inicializa a SM com a frequencia de 800kHz para NeoPixel
-  ws2818b_program_init(np_pio, sm, offset, pin, 800000.f);
+  hal_np_init(pin, NP_LANES);
 
   // Zera o buffer inicial
   for (uint i = 0; i < LED_COUNT; i++)
   {
-    leds[i].R = 0;
-    leds[i].G = 0;
-    leds[i].B = 0;
+    leds[i] = 0;
   }
 }
 
@@ -138,63 +203,272 @@ void npClear()
 }
 
 //------------------------------------------------------------------------------
-// npWrite: Envia o conteúdo do buffer leds[] para a fita/matriz WS2812
+// npWriteAsync: Inicia o envio de leds[] por DMA e retorna imediatamente.
+// O reset (latch) dos WS2812 é contado por um alarme, sem bloquear a CPU.
 //------------------------------------------------------------------------------
-void npWrite()
+void __not_in_flash_func(npWriteAsync)()
 {
+  npWaitDone();
+
+  // Converte as intensidades 8.8 nas palavras GRB enviadas aos LEDs. Com o
+  // pontilhamento, a fração que sobra em um frame é somada no próximo
   for (uint i = 0; i < LED_COUNT; i++)
   {
-    pio_sm_put_blocking(np_pio, sm, leds[i].G);
-    pio_sm_put_blocking(np_pio, sm, leds[i].R);
-    pio_sm_put_blocking(np_pio, sm, leds[i].B);
+    uint32_t palavra = 0;
+    for (uint c = 0; c < 3; c++)
+    {
+#if NP_TEMPORAL_DITHER
+      uint16_t valor = leds_intensidade[i][c] + leds_erro[i][c];
+      leds_erro[i][c] = valor & 0xFF;
+#else
+      uint16_t valor = leds_intensidade[i][c] + 0x80;
+#endif
+      palavra = (palavra << 8) | (valor >> 8);
+    }
+    leds[i] = palavra << 8;
   }
-  // Pequeno delay para resetar o sinal dos WS2812
-  sleep_us(100);
+
+#if NP_LANES > 1
+  np_lanes_transpose(leds, NP_LANE_LEDS, NP_LANES, leds_lanes);
+  hal_np_write_async(leds_lanes, NP_LANE_LEDS);
+#else
+  hal_np_write_async(leds, LED_COUNT);
+#endif
 }
 
 //------------------------------------------------------------------------------
-// inimigo_colide: Verifica se o sprite do dino e o inimigo se sobrepõem.
+// npWrite: Envia o conteúdo do buffer leds[] para a fita/matriz WS2812 e
+// espera o envio terminar
 //------------------------------------------------------------------------------
-// Retorna != 0 se as coordenadas do inimigo contiverem algum pixel != 0 no
-// sprite do dino, caracterizando colisão.
+void npWrite()
+{
+  npWriteAsync();
+  npWaitDone();
+}
+
+//------------------------------------------------------------------------------
+// Renderização no core 1
+//------------------------------------------------------------------------------
+// O core 0 lê os botões, roda a lógica e publica cada frame pronto numa fila
+// sem trava; o core 1 desenha os LEDs e envia o OLED. Se o renderizador
+// atrasa, a fila enche e o core 0 descarta o frame novo em vez de esperar; o
+// renderizador, por sua vez, sempre pula direto para o frame mais recente.
 //------------------------------------------------------------------------------
-int inimigo_colide(int posicao[2], int matriz[5][5][3])
+
+// Frame pronto para renderização: camadas dos LEDs e, opcionalmente, o OLED
+typedef struct
 {
-  int linha = posicao[0];
-  int coluna = posicao[1];
-  return (matriz[linha][coluna][0] != 0 ||
-          matriz[linha][coluna][1] != 0 ||
-          matriz[linha][coluna][2] != 0);
+  sprite_t camadas[1 + OBSTACULOS_TIPOS];
+  bool tem_oled;
+  uint8_t oled[ssd1306_buffer_length];
+  ssd1306_scroll_interval_t rolagem; // Rolagem do chão (DINO_OLED_MUNDO)
+} frame_t;
+
+#define FRAMES_NA_FILA 4
+
+frame_t frames[FRAMES_NA_FILA];
+spsc_queue_t fila_frames;
+
+// Contadores: frames publicados e descartados (fila cheia) pelo core 0, e
+// pulados pelo core 1 (substituídos por um mais novo antes de desenhar)
+uint32_t frames_publicados = 0;
+uint32_t frames_descartados = 0;
+uint32_t frames_pulados = 0;
+
+// Frames consumidos pelo renderizador com tudo o que desenharam já enviado (ou
+// em envio). Igual a frames_publicados: renderizador ocioso, nada pendente
+uint32_t frames_renderizados = 0;
+
+// Verdadeiro se o renderizador roda no core 1; senão (host) roda no loop
+bool render_no_core1 = false;
+
+// Displays: o placar (ou o mundo) no i2c1 e o painel de estatísticas no i2c0
+ssd1306_t oled_placar;
+#if DINO_OLED_PAINEL
+ssd1306_t oled_painel;
+
+//------------------------------------------------------------------------------
+// atualiza_painel: Redesenha o painel com os contadores, a cada
+// PAINEL_INTERVALO_US, sem esperar o envio anterior terminar. Retorna true se
+// o painel desenhado ainda não pôde ser enviado
+//------------------------------------------------------------------------------
+bool atualiza_painel()
+{
+  static uint64_t ultima_atualizacao = 0;
+  static uint32_t publicados_antes = 0;
+  static bool painel_pendente = false;
+  uint64_t agora = hal_time_us();
+
+  if (painel_pendente)
+  {
+    painel_pendente = !ssd1306_flush_async(&oled_painel);
+    return painel_pendente;
+  }
+  if (agora - ultima_atualizacao < PAINEL_INTERVALO_US || ssd1306_flush_busy(&oled_painel))
+    return false;
+
+  // Frames publicados por segundo desde a última atualização
+  uint32_t publicados = frames_publicados;
+  uint32_t fps = (uint32_t)((uint64_t)(publicados - publicados_antes) * 1000000 / (agora - ultima_atualizacao));
+  publicados_antes = publicados;
+  ultima_atualizacao = agora;
+
+  char linhas[4][24];
+  snprintf(linhas[0], sizeof(linhas[0]), "TICKS %lu", (unsigned long)tick_stats()->ticks);
+  snprintf(linhas[1], sizeof(linhas[1]), "FPS %lu", (unsigned long)fps);
+  snprintf(linhas[2], sizeof(linhas[2]), "DESCART %lu", (unsigned long)frames_descartados);
+  snprintf(linhas[3], sizeof(linhas[3]), "PULADOS %lu", (unsigned long)frames_pulados);
+
+  uint32_t prof_inicio = prof_begin();
+  uint8_t *buffer = ssd1306_buffer(&oled_painel);
+  memset(buffer, 0, ssd1306_buffer_length);
+  for (uint j = 0; j < count_of(linhas); j++)
+  {
+    ssd1306_draw_string(buffer, 0, j * 8, linhas[j]);
+  }
+  prof_end(PROF_PAINEL_TEXT, prof_inicio);
+  painel_pendente = !ssd1306_flush_async(&oled_painel);
+  return painel_pendente;
 }
+#endif
 
+#if DINO_TELEMETRIA
 //------------------------------------------------------------------------------
-// copia_sprite: Copia o conteúdo de uma matriz 5x5x3 para outra
+// telemetria_janela: Publica cada janela enviada a um display (no núcleo do
+// renderizador)
 //------------------------------------------------------------------------------
-void copia_sprite(int src[5][5][3], int dst[5][5][3])
+void telemetria_janela(const ssd1306_t *ssd, const struct render_area *janela)
 {
-  for (int i = 0; i < 5; i++)
+  telemetria_oled(ssd->i2c_port, janela->start_column, janela->end_column, janela->start_page,
+                  janela->end_page, ssd->front + 1);
+}
+#endif
+
+//------------------------------------------------------------------------------
+// texto_liberado: O printf pode escrever agora? Com a telemetria, só entre
+// quadros: o texto no meio de um quadro meio enviado o corromperia
+//------------------------------------------------------------------------------
+bool texto_liberado()
+{
+#if DINO_TELEMETRIA
+  return !telemetria_quadro_aberto();
+#else
+  return true;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// renderiza_frames: Consome a fila e desenha o frame mais recente. Retorna
+// true se ficou algum envio a tentar de novo (display ocupado)
+//------------------------------------------------------------------------------
+bool __not_in_flash_func(renderiza_frames)()
+{
+  // OLED desenhado mas ainda não enviado (display ocupado)
+  static bool oled_pendente = false;
+  static uint32_t consumidos = 0;
+#if DINO_OLED_MUNDO
+  // Rolagem do chão pedida pelo último frame e a que está ativa no display
+  static ssd1306_scroll_interval_t rolagem;
+  static bool rolando = false;
+  static ssd1306_scroll_interval_t rolagem_ativa;
+#endif
+  sprite_t camadas[1 + OBSTACULOS_TIPOS];
+  int lidos = 0;
+  int slot;
+
+  while ((slot = spsc_peek(&fila_frames)) >= 0)
   {
-    for (int j = 0; j < 5; j++)
+    frame_t *frame = &frames[slot];
+    memcpy(camadas, frame->camadas, sizeof(camadas));
+    if (frame->tem_oled)
     {
-      dst[i][j][0] = src[i][j][0];
-      dst[i][j][1] = src[i][j][1];
-      dst[i][j][2] = src[i][j][2];
+      memcpy(ssd1306_buffer(&oled_placar), frame->oled, ssd1306_buffer_length);
+      oled_pendente = true;
+#if DINO_OLED_MUNDO
+      rolagem = frame->rolagem;
+#endif
     }
+    spsc_release(&fila_frames);
+    lidos++;
+  }
+
+  if (lidos)
+  {
+    frames_pulados += lidos - 1;
+    consumidos += lidos;
+
+    uint32_t prof_inicio = prof_begin();
+    setLeds(camadas, count_of(camadas));
+    prof_end(PROF_COMPOSE, prof_inicio);
+
+    prof_inicio = prof_begin();
+    npWriteAsync();
+    prof_end(PROF_NP_WRITE, prof_inicio);
+
+#if DINO_TELEMETRIA
+    telemetria_leds(leds, NP_WIDTH, NP_HEIGHT);
+#endif
   }
+
+#if DINO_OLED_MUNDO
+  // Inicia a rolagem do chão ou muda a sua velocidade. Isso reenvia a página
+  // do chão e bloqueia, mas só acontece quando a velocidade do jogo muda
+  if (oled_pendente && (!rolando || rolagem != rolagem_ativa) && !ssd1306_flush_busy(&oled_placar))
+  {
+    ssd1306_scroll_pages(&oled_placar, OLED_MUNDO_PAGINA_CHAO, OLED_MUNDO_PAGINA_CHAO, rolagem, true);
+    rolagem_ativa = rolagem;
+    rolando = true;
+  }
+#endif
+
+  // Envia o OLED sem bloquear; se o display ainda estiver ocupado com o envio
+  // anterior, tenta de novo na próxima chamada
+  if (oled_pendente && ssd1306_flush_async(&oled_placar))
+  {
+    oled_pendente = false;
+  }
+
+  bool pendente = oled_pendente;
+#if DINO_OLED_PAINEL
+  // O painel está em outro barramento: o seu envio corre junto com o do placar
+  pendente |= atualiza_painel();
+#endif
+
+  if (!pendente)
+  {
+    __atomic_store_n(&frames_renderizados, consumidos, __ATOMIC_RELEASE);
+  }
+  return pendente;
+}
+
+//------------------------------------------------------------------------------
+// espera_displays: Espera os envios em curso aos displays terminarem, para o
+// renderizador tentar de novo o que ficou pendente
+//------------------------------------------------------------------------------
+void espera_displays()
+{
+  ssd1306_flush_wait(&oled_placar);
+#if DINO_OLED_PAINEL
+  ssd1306_flush_wait(&oled_painel);
+#endif
 }
 
 //------------------------------------------------------------------------------
-// limpa_sprite: Zera todos os pixels de uma matriz 5x5x3
+// core1_main: Laço do renderizador; dorme até o core 0 publicar um frame.
+// Com um envio pendente não dorme: espera o display liberar e tenta de novo,
+// senão o último frame (o do Game Over) poderia nunca ser enviado
 //------------------------------------------------------------------------------
-void limpa_sprite(int sprite[5][5][3])
+void __not_in_flash_func(core1_main)()
 {
-  for (int i = 0; i < 5; i++)
+  while (true)
   {
-    for (int j = 0; j < 5; j++)
+    if (renderiza_frames())
+    {
+      espera_displays();
+    }
+    else
     {
-      sprite[i][j][0] = 0;
-      sprite[i][j][1] = 0;
-      sprite[i][j][2] = 0;
+      hal_wait_event();
     }
   }
 }
@@ -204,251 +478,420 @@ void limpa_sprite(int sprite[5][5][3])
 //------------------------------------------------------------------------------
 int main()
 {
-  // Usa tempo em microssegundos desde o boot como semente de rand(),
-  // garantindo seeds mais variadas.
-  srand((unsigned)to_us_since_boot(get_absolute_time()));
-
   // Flag que indica se houve colisão (Game Over)
   int colidiu = 0;
 
-  // Inicializa GPIO dos botões (pulo e abaixar)
-  gpio_init(BUTTON_PIN);
-  gpio_set_dir(BUTTON_PIN, GPIO_IN);
-  gpio_pull_up(BUTTON_PIN);
+  // Habilita entrada/saída padrão
+  hal_init();
+
+  // Usa tempo em microssegundos desde o boot como semente dos inimigos,
+  // garantindo seeds mais variadas. A semente e as entradas de cada tick são
+  // gravadas para que a partida possa ser reproduzida
+  uint32_t semente = (uint32_t)hal_time_us();
+  bool reproduzindo = false;
+#ifdef DINO_HOST
+  // No host, DINO_REPLAY=arquivo reproduz uma partida gravada (com DINO_RECORD)
+  const char *log_reproduzido = getenv("DINO_REPLAY");
+  if (log_reproduzido)
+  {
+    reproduzindo = replay_play_file(log_reproduzido, &semente);
+    if (!reproduzindo)
+    {
+      printf("replay: log inválido: %s\n", log_reproduzido);
+      return 1;
+    }
+  }
+#endif
+  if (!reproduzindo)
+  {
+    replay_record_start(semente);
+  }
+
+  // Recordes das partidas anteriores (uma varredura da flash). Antes da
+  // partida, com o jogo parado, termina o que ficou pendente na flash, como
+  // apagar o próximo setor do log
+  recordes_init();
+  const recordes_t *recordes = recordes_atuais();
+  printf("recordes: %lu partidas, melhor: %lu\n", (unsigned long)recordes->partidas,
+         (unsigned long)recordes->melhores[0]);
+  while (recordes_trabalha())
+  {
+  }
 
-  gpio_init(BUTTON_PIN2);
-  gpio_set_dir(BUTTON_PIN2, GPIO_IN);
-  gpio_pull_up(BUTTON_PIN2);
+  // Inicializa os botões (pulo e abaixar) com interrupção de borda e debounce
+  input_init(BUTTON_PIN, INPUT_DEBOUNCE_US);
+  input_init(BUTTON_PIN2, INPUT_DEBOUNCE_US);
 
-  // Habilita entrada/saída padrão
-  stdio_init_all();
+  // Maior tempo entre a borda de um botão e seu tratamento pela lógica (us)
+  uint64_t maior_latencia_entrada = 0;
 
   // Inicia LEDs e limpa
   npInit(LED_PIN);
   npClear();
 
-  // Sprites do dinossauro em diferentes posições (em pé, pulando, abaixado)
-  int sprite_dinossauro_em_pe[5][5][3] = {
-      {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-      {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-      {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-      {{0, 0, 255}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-      {{0, 0, 255}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-  };
+  // Estado da partida: dino, inimigos (sorteados a partir da semente, o
+  // replay reproduz os mesmos padrões), tempo e placar
+  static jogo_t jogo;
+  jogo_init(&jogo, DINO_DIFICULDADE, &jogo_curva_padrao, semente);
 
-  int sprite_dinossauro_pulando[5][5][3] = {
-      {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-      {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-      {{0, 0, 255}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-      {{0, 0, 255}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-      {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
+  // Camadas do frame: dino embaixo, inimigos por cima (uma camada por tipo)
+  sprite_t camadas[1 + OBSTACULOS_TIPOS] = {
+      {.mask = jogo.dino_mask, .paleta = COR_DINO},
+      [1 + OBSTACULO_NORMAL] = {.mask = 0, .paleta = COR_INIMIGO},
+      [1 + OBSTACULO_RAPIDO] = {.mask = 0, .paleta = COR_INIMIGO_RAPIDO},
   };
 
-  int sprite_dinossauro_abaixado[5][5][3] = {
-      {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-      {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-      {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-      {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-      {{0, 0, 255}, {0, 0, 255}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}},
-  };
+  // Duração de um passo lógico do jogo (ms), dividido em subpassos da física
+  int sleep_delay = FISICA_PASSO_US / 1000;
 
-  // Controle do dino
-  int pulo = 0;
-  int pulo_delay = 200;
-  int abaixado = 0;
-  int abaixado_delay = 200;
-
-  // Variáveis do inimigo: posicao_inimigo[0] => linha, [1] => coluna
-  // Inicia fora da tela (coluna -1)
-  int posicao_inimigo[2] = {4, -1};
-
-  // Sprite temporário do dino + inimigo
-  int sprite_atual[5][5][3];
-  limpa_sprite(sprite_atual);
-
-  // Tempo total de um "ciclo" e steps
-  int total_delay = 1000;
-  int sleep_delay = 10;
-  int steps = total_delay / sleep_delay;
-
-  // Ajustes de delay do inimigo
-  int inimigo_delay_minimo = 50;
-  int inimigo_delay = 200;
-  int inimigo_delay_reducao = 25;
-  int segundos_para_reducao_de_velocidade = 5;
-  int inimigo_delay_atual = inimigo_delay;
-
-  // Placar de inimigos desviados
-  int inimigos_desviados = 0;
+  // Placar de inimigos desviados: redesenhado quando muda
   int atualiza_mensagem_de_inimigos_desviados = 0;
 
   // Inicializa I2C e o display SSD1306
-  i2c_init(i2c1, ssd1306_i2c_clock * 1000);
-  gpio_set_function(14, GPIO_FUNC_I2C);
-  gpio_set_function(15, GPIO_FUNC_I2C);
-  gpio_pull_up(14);
-  gpio_pull_up(15);
-
-  ssd1306_init();
-
-  // Prepara a "área" de renderização no display (full screen)
-  struct render_area frame_area = {
-      .start_column = 0,
-      .end_column = ssd1306_width - 1,
-      .start_page = 0,
-      .end_page = ssd1306_n_pages - 1};
-  calculate_render_area_buffer_length(&frame_area);
-
-  // Limpa o display
-  uint8_t ssd[ssd1306_buffer_length];
-  memset(ssd, 0, ssd1306_buffer_length);
-  render_on_display(ssd, &frame_area);
+  uint oled_clock = ssd1306_i2c_clock * 1000;
+  hal_i2c_init(HAL_I2C1, I2C_SDA, I2C_SCL, oled_clock);
+  ssd1306_init(&oled_placar, ssd1306_width, ssd1306_height, false, ssd1306_i2c_address, HAL_I2C1);
+#if DINO_OLED_FMPLUS
+  oled_clock = ssd1306_fast_mode_plus(&oled_placar, oled_clock);
+#endif
+
+#if DINO_TELEMETRIA
+  // Telemetria: a serial é alimentada enquanto o loop espera o próximo tick
+  telemetria_init();
+  tick_set_idle(telemetria_envia);
+  oled_placar.on_window = telemetria_janela;
+#endif
+
+  // Limpa o display (o framebuffer começa apagado)
+  ssd1306_flush(&oled_placar);
+
+#if DINO_OLED_PAINEL
+  hal_i2c_init(HAL_I2C0, I2C_PAINEL_SDA, I2C_PAINEL_SCL, ssd1306_i2c_clock * 1000);
+  ssd1306_init(&oled_painel, ssd1306_width, 32, false, ssd1306_i2c_address, HAL_I2C0);
+#if DINO_TELEMETRIA
+  oled_painel.on_window = telemetria_janela;
+#endif
+  ssd1306_flush(&oled_painel);
+#endif
 
   // Desenha o dinossauro em pé inicialmente
-  setLeds(sprite_dinossauro_em_pe);
+  setLeds(camadas, 1);
   npWrite();
 
-  // Usado para medir tempo de redução de velocidade do inimigo
-  clock_t tempo_desde_velocidade_atualizada = clock();
+  // A partir daqui LEDs e display pertencem ao renderizador (core 1)
+  spsc_init(&fila_frames, FRAMES_NA_FILA);
+  render_no_core1 = hal_launch_core1(core1_main);
+
+  // Relógio do jogo: um tick lógico a cada sleep_delay ms, gerado por timer.
+  // Reproduzindo, os ticks são entregues sem esperar (avanço rápido)
+  tick_init(sleep_delay * 1000);
+  tick_set_fast_forward(reproduzindo);
+
+  // Hash do estado do jogo no último tick (conferido pelo replay)
+  uint32_t hash_estado = 0;
+
+  // O trabalho de um tick (e cada atualização lógica) deve caber no período.
+  // O resumo do perfilador sai no stdio a cada PROF_INTERVALO_MS de jogo
+  prof_set_budget(PROF_FRAME, sleep_delay * 1000);
+  prof_set_budget(PROF_LOGIC, sleep_delay * 1000);
+  uint32_t ultimo_resumo_prof = 0;
 
   // Loop principal do jogo
   while (true)
   {
+    // Espera o próximo tick. Se a renderização atrasou, roda as atualizações
+    // lógicas pendentes em sequência antes de desenhar de novo
+    uint atualizacoes = tick_wait();
+    uint32_t prof_frame = prof_begin();
 
-    for (int i = 0; i < steps; i++)
+    for (uint t = 0; t < atualizacoes && !colidiu; t++)
     {
-      // A cada "passo", resetamos a flag de msg no display
-      atualiza_mensagem_de_inimigos_desviados = 0;
+      uint32_t prof_inicio = prof_begin();
+      // Eventos dos botões desde o último tick: um toque que começa e termina
+      // entre dois ticks ainda conta como pulo
+      bool botao_pulo = false;
+      bool botao_abaixar = false;
+      input_event_t evento;
+      while (input_poll(&evento))
+      {
+        if (!evento.pressed)
+          continue;
 
-      // Limpa sprite_atual para refazer o frame
-      limpa_sprite(sprite_atual);
+        uint64_t latencia = hal_time_us() - evento.time_us;
+        maior_latencia_entrada = max(maior_latencia_entrada, latencia);
 
-      // Leitura dos botões (puxados para cima, logo 0 = pressionado)
-      if (gpio_get(BUTTON_PIN) == 0)
-      {
-        pulo = 1;
-        pulo_delay = 100;
-      }
-      else if (pulo_delay <= 0)
-      {
-        pulo = 0;
+        if (evento.pin == BUTTON_PIN)
+          botao_pulo = true;
+        else if (evento.pin == BUTTON_PIN2)
+          botao_abaixar = true;
       }
 
-      if (gpio_get(BUTTON_PIN2) == 0)
-      {
-        abaixado = 1;
-      }
-      else if (abaixado_delay <= 0)
-      {
-        abaixado = 0;
-      }
+      prof_end(PROF_INPUT, prof_inicio);
+      prof_inicio = prof_begin();
 
-      // Escolhe qual sprite de dino usar (em pé, pulando ou abaixado)
-      if (abaixado)
-      {
-        copia_sprite(sprite_dinossauro_abaixado, sprite_atual);
-      }
-      else if (pulo)
+      // Botões mantidos pressionados continuam valendo
+      botao_pulo = botao_pulo || input_pressed(BUTTON_PIN);
+      botao_abaixar = botao_abaixar || input_pressed(BUTTON_PIN2);
+
+      // Grava as entradas do tick ou, reproduzindo, usa as gravadas. Se o log
+      // acabar antes da colisão, a partida termina: a reprodução divergiu, ou
+      // chegou ao fim de um log truncado
+      uint8_t entradas = (botao_pulo ? ENTRADA_PULO : 0) | (botao_abaixar ? ENTRADA_ABAIXAR : 0);
+      if (!replay_tick(&entradas))
       {
-        copia_sprite(sprite_dinossauro_pulando, sprite_atual);
+        colidiu = 1;
+        break;
       }
-      else
+
+      // Um tick da lógica; os que saíram pela esquerda foram desviados
+      if (jogo_passo(&jogo, entradas))
       {
-        copia_sprite(sprite_dinossauro_em_pe, sprite_atual);
+        atualiza_mensagem_de_inimigos_desviados = 1;
       }
+      colidiu = jogo.colidiu;
 
-      // Lógica de movimentação do inimigo
-      if (inimigo_delay_atual <= 0)
+      // Camadas do frame: o dino e uma camada por tipo de inimigo
+      camadas[0].mask = jogo.dino_mask;
+      for (uint tipo = 0; tipo < OBSTACULOS_TIPOS; tipo++)
       {
-        // Se inimigo saiu da tela, reaparece
-        if (posicao_inimigo[1] == -1)
-        {
-          posicao_inimigo[1] = 4;              // coluna inicial
-          posicao_inimigo[0] = rand() % 3 + 2; // linha aleatória (2..4)
-        }
-        else
-        {
-          // Move o inimigo para a esquerda
-          posicao_inimigo[1]--;
-          // Se saiu da coluna -1, significa que o dino desviou
-          if (posicao_inimigo[1] == -1)
-          {
-            inimigos_desviados++;
-            atualiza_mensagem_de_inimigos_desviados = 1;
-          }
-        }
-        // Se passou X segundos, reduz delay (aumenta velocidade)
-        clock_t tempo_agora = clock();
-        if ((tempo_agora - tempo_desde_velocidade_atualizada) / CLOCKS_PER_SEC >= segundos_para_reducao_de_velocidade)
-        {
-          inimigo_delay = max(inimigo_delay - inimigo_delay_reducao, inimigo_delay_minimo);
-          tempo_desde_velocidade_atualizada = tempo_agora;
-        }
-        // Reinicia o contador de delay do inimigo
-        inimigo_delay_atual = inimigo_delay;
+        camadas[1 + tipo].mask = jogo.mascaras[tipo];
       }
 
-      // Verifica colisão (Game Over se colidiu)
-      if (inimigo_colide(posicao_inimigo, sprite_atual))
+      // Estado do jogo após o tick, conferido contra a gravação
+      uint32_t estado[] = {jogo.dino_mask, jogo.mascaras[OBSTACULO_NORMAL],
+                           jogo.mascaras[OBSTACULO_RAPIDO], jogo.desviados,
+                           (uint32_t)jogo.dino.altura};
+      hash_estado = replay_hash(estado, count_of(estado));
+      replay_check(hash_estado);
+
+#if DINO_TELEMETRIA
+      telemetria_estado_t telemetria = {
+          .tick = jogo.tempo_ms / sleep_delay,
+          .entradas = entradas,
+          .botoes = (input_pressed(BUTTON_PIN) ? ENTRADA_PULO : 0) |
+                    (input_pressed(BUTTON_PIN2) ? ENTRADA_ABAIXAR : 0),
+          .colidiu = jogo.colidiu,
+          .desviados = jogo.desviados,
+          .altura = jogo.dino.altura,
+          .periodo_us = jogo.periodo_us,
+          .dino = jogo.dino_mask,
+      };
+      memcpy(telemetria.inimigos, jogo.mascaras, sizeof(telemetria.inimigos));
+      telemetria_estado(&telemetria);
+#endif
+
+      prof_end(PROF_LOGIC, prof_inicio);
+    }
+
+    // Publica o frame para o renderizador. Com a fila cheia o frame é
+    // descartado; um placar não publicado fica para o próximo frame. O frame
+    // da colisão é o último: espera o renderizador liberar um slot
+    uint32_t prof_inicio = prof_begin();
+    int slot = spsc_reserve(&fila_frames);
+    while (slot < 0 && colidiu)
+    {
+      if (render_no_core1)
       {
-        colidiu = 1;
+        hal_wait_event();
       }
-
-      // Se o inimigo está visível, pinta ele de vermelho
-      if (posicao_inimigo[1] != -1)
+      else
       {
-        int L = posicao_inimigo[0];
-        int C = posicao_inimigo[1];
-        sprite_atual[L][C][0] = 255;
-        sprite_atual[L][C][1] = 0;
-        sprite_atual[L][C][2] = 0;
+        renderiza_frames();
       }
-
-      // Copia sprite para o buffer de LEDs e escreve fisicamente
-      setLeds(sprite_atual);
-      npWrite();
-
-      // Pequeno delay entre cada "step"
-      sleep_ms(sleep_delay);
-
-      // Decrementa timers de pulo, abaixado e do inimigo
-      if (pulo_delay >= 0)
-        pulo_delay -= sleep_delay;
-      if (abaixado_delay >= 0)
-        abaixado_delay -= sleep_delay;
-      if (inimigo_delay_atual >= 0)
-        inimigo_delay_atual -= sleep_delay;
-
-      // Se desviou, atualiza mensagem no display
+      slot = spsc_reserve(&fila_frames);
+    }
+    if (slot < 0)
+    {
+      frames_descartados++;
+    }
+    else
+    {
+      frame_t *frame = &frames[slot];
+      memcpy(frame->camadas, camadas, sizeof(camadas));
+#if DINO_OLED_MUNDO
+      // Visão do mundo: o frame é sempre redesenhado; o envio só transmite as
+      // janelas que mudaram, fora a página do chão, que rola no display
+      frame->tem_oled = true;
+      memset(frame->oled, 0, ssd1306_buffer_length);
+      oled_mundo_desenha(frame->oled, jogo.dino_mask, jogo.dino.altura, &jogo.inimigos, jogo.desviados);
+      frame->rolagem = oled_mundo_rolagem(jogo.periodo_us / 1000);
+      // O placar faz parte da cena, então não precisa de aviso próprio
+      (void)atualiza_mensagem_de_inimigos_desviados;
+#else
+      frame->tem_oled = atualiza_mensagem_de_inimigos_desviados;
+
+      // Se desviou, desenha a mensagem do display no frame
       if (atualiza_mensagem_de_inimigos_desviados)
       {
-        // Apaga a tela
-        memset(ssd, 0, ssd1306_buffer_length);
-        render_on_display(ssd, &frame_area);
+        // Redesenha a tela do zero; o envio só transmite o que mudou
+        memset(frame->oled, 0, ssd1306_buffer_length);
 
-        // Cria mensagem de "Dino Runner" + quantidade de desviados
-        char str[16];
-        sprintf(str, "  Desviados: %d", inimigos_desviados);
+        // Cria mensagem de "Dino Runner" + quantidade de desviados (a partir
+        // de 3 dígitos passa de 16 caracteres; o que sair da tela é cortado)
+        char str[24];
+        snprintf(str, sizeof(str), "  Desviados: %lu", (unsigned long)jogo.desviados);
+        char recorde[24];
+        snprintf(recorde, sizeof(recorde), "  Recorde: %lu",
+                 (unsigned long)max(recordes->melhores[0], jogo.desviados));
 
         char *text[] = {
             "  Dino Runner   ",
-            str};
+            str,
+            recorde};
 
         // Desenha essas linhas no buffer do display
+        uint32_t prof_texto = prof_begin();
         int y = 0;
         for (uint j = 0; j < count_of(text); j++)
         {
-          ssd1306_draw_string(ssd, 5, y, text[j]);
+          ssd1306_draw_string(frame->oled, 5, y, text[j]);
           y += 8;
         }
-        render_on_display(ssd, &frame_area);
+        prof_end(PROF_OLED_TEXT, prof_texto);
+        atualiza_mensagem_de_inimigos_desviados = 0;
+      }
+#endif
+
+      spsc_commit(&fila_frames);
+      frames_publicados++;
+      hal_signal_event();
+    }
+    prof_end(PROF_PUBLISH, prof_inicio);
+    prof_end(PROF_FRAME, prof_frame);
+
+    if (!render_no_core1)
+    {
+      renderiza_frames();
+    }
+
+#if DINO_TELEMETRIA
+    telemetria_envia();
+#endif
+
+    // Resumo periódico do perfilador (fora das medições), adiado enquanto
+    // houver um quadro da telemetria pela metade na serial
+    if (tick_elapsed_ms() - ultimo_resumo_prof >= PROF_INTERVALO_MS && texto_liberado())
+    {
+      ultimo_resumo_prof = tick_elapsed_ms();
+      prof_dump();
+    }
+
+    // Se colidiu, encerramos o jogo (retorna ao sistema)
+    if (colidiu)
+    {
+      // Espera o renderizador desenhar e enviar o último frame. No host ele
+      // roda aqui mesmo, então o loop o chama até não sobrar envio pendente
+      while (__atomic_load_n(&frames_renderizados, __ATOMIC_ACQUIRE) != frames_publicados)
+      {
+        if (!render_no_core1 && renderiza_frames())
+        {
+          espera_displays();
+        }
+        tight_loop_contents();
       }
 
-      // Se colidiu, encerramos o jogo (retorna ao sistema)
-      if (colidiu)
+#if DINO_TELEMETRIA
+      // Dá um tempo para a telemetria pendente (o último frame) sair. Os
+      // printf abaixo precisam da serial entre quadros; se o quadro atual
+      // ainda não saiu no prazo, ninguém está lendo a USB e o texto também
+      // não chegaria
+      uint64_t limite_telemetria = hal_time_us() + TELEMETRIA_FIM_US;
+      while (telemetria_pendente() && hal_time_us() < limite_telemetria)
+      {
+        telemetria_envia();
+        hal_sleep_us(1000);
+      }
+#endif
+
+      // Contabilidade do relógio: ticks atrasados/descartados pela renderização
+      const tick_stats_t *relogio = tick_stats();
+      printf("ticks: %lu atrasados: %lu descartados: %lu maior atraso: %lu\n",
+             (unsigned long)relogio->ticks, (unsigned long)relogio->late,
+             (unsigned long)relogio->dropped, (unsigned long)relogio->max_backlog);
+      printf("frames: %lu publicados, %lu descartados, %lu pulados\n",
+             (unsigned long)frames_publicados, (unsigned long)frames_descartados,
+             (unsigned long)frames_pulados);
+      const input_stats_t *entrada = input_stats();
+      printf("entrada: %lu eventos, %lu trepidações, %lu perdidos, maior latência: %llu us\n",
+             (unsigned long)entrada->events, (unsigned long)entrada->bounces,
+             (unsigned long)entrada->dropped, (unsigned long long)maior_latencia_entrada);
+      const ssd1306_tx_stats_t *oled = ssd1306_tx_stats(HAL_I2C1);
+      printf("oled: %u kHz, %lu envios, %lu transações, %llu bytes\n", oled_clock / 1000,
+             (unsigned long)oled->flushes, (unsigned long)oled->transactions,
+             (unsigned long long)oled->bytes);
+#if DINO_OLED_PAINEL
+      const ssd1306_tx_stats_t *painel = ssd1306_tx_stats(HAL_I2C0);
+      printf("painel: %lu envios, %lu transações, %llu bytes\n",
+             (unsigned long)painel->flushes, (unsigned long)painel->transactions,
+             (unsigned long long)painel->bytes);
+#endif
+#if DINO_TELEMETRIA
+      const telemetria_stats_t *telemetria = telemetria_stats();
+      printf("telemetria: %lu bytes, pacotes (estado/leds/oled): %lu/%lu/%lu enviados, %lu/%lu/%lu descartados\n",
+             (unsigned long)telemetria->bytes, (unsigned long)telemetria->enviados[TELEMETRIA_ESTADO],
+             (unsigned long)telemetria->enviados[TELEMETRIA_LEDS], (unsigned long)telemetria->enviados[TELEMETRIA_OLED],
+             (unsigned long)telemetria->descartados[TELEMETRIA_ESTADO],
+             (unsigned long)telemetria->descartados[TELEMETRIA_LEDS],
+             (unsigned long)telemetria->descartados[TELEMETRIA_OLED]);
+#endif
+      prof_dump();
+
+      // Recordes: a partida entra na cópia em RAM e é gravada na flash agora,
+      // com o jogo parado (partidas reproduzidas não contam)
+      if (!reproduzindo)
+      {
+        int posicao = recordes_registra(jogo.desviados, jogo.dino.pulos, jogo.tempo_ms);
+        while (recordes_trabalha())
+        {
+        }
+        if (posicao == 0)
+        {
+          printf("novo recorde: %lu\n", (unsigned long)jogo.desviados);
+        }
+      }
+      printf("recordes: %lu partidas, melhores:", (unsigned long)recordes->partidas);
+      for (uint i = 0; i < RECORDES_MELHORES; i++)
+      {
+        printf(" %lu", (unsigned long)recordes->melhores[i]);
+      }
+      const recordes_stats_t *flash = recordes_stats();
+      printf(", flash: %lu válidos, %lu corrompidos, %lu apagamentos, %lu gravações, %lu falhas\n",
+             (unsigned long)flash->validos, (unsigned long)flash->corrompidos,
+             (unsigned long)flash->apagamentos, (unsigned long)flash->programacoes,
+             (unsigned long)flash->falhas);
+
+      // Replay: confere o fim da reprodução ou envia o log gravado
+      replay_finish(hash_estado);
+      const replay_stats_t *replay = replay_stats();
+      if (reproduzindo)
+      {
+        printf("replay: %lu ticks, %lu checagens, %lu divergências",
+               (unsigned long)replay->ticks, (unsigned long)replay->checkpoints,
+               (unsigned long)replay->mismatches);
+        if (replay->mismatches)
+        {
+          printf(" (primeira no tick %ld)", (long)replay->first_mismatch);
+        }
+        if (replay->truncated)
+        {
+          printf(", log truncado no tick %lu", (unsigned long)replay->truncated_tick);
+        }
+        printf("\n");
+        return replay->mismatches ? 1 : 0;
+      }
+      if (replay->truncated)
+      {
+        printf("replay: log cheio no tick %lu\n", (unsigned long)replay->truncated_tick);
+      }
+      replay_dump();
+#ifdef DINO_HOST
+      const char *log_gravado = getenv("DINO_RECORD");
+      if (log_gravado && !replay_save_file(log_gravado))
       {
-        return 0;
+        printf("replay: não foi possível gravar %s\n", log_gravado);
       }
+#endif
+      return 0;
     }
   }
 }
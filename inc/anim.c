@@ -0,0 +1,196 @@
+#include <string.h>
+#include "anim.h"
+#include "ssd1306.h"
+
+#define ANIM_SKIP_MAX 128
+#define ANIM_RUN_MAX 64
+#define ANIM_OP_RUN 0x80
+#define ANIM_OP_LITERAL 0xC0
+
+static const uint8_t anim_magic[2] = {'D', 'A'};
+
+bool anim_start(anim_player_t *p, ssd1306_t *ssd, const uint8_t *stream, size_t length, bool loop) {
+    if (length < ANIM_HEADER_BYTES || memcmp(stream, anim_magic, sizeof(anim_magic)) != 0 ||
+        stream[2] != ANIM_VERSION || stream[3] != ssd->width || stream[4] != ssd->pages ||
+        ssd->width != ssd1306_width) {
+        return false;
+    }
+
+    memset(p, 0, sizeof(*p));
+    p->stream = stream;
+    p->length = length;
+    p->frames = (uint16_t)(stream[6] | stream[7] << 8);
+    p->period_us = (uint32_t)(stream[8] | stream[9] << 8) * 1000;
+    p->frame_bytes = (uint16_t)(ssd->width * ssd->pages);
+    p->pages = ssd->pages;
+    p->loop = loop;
+    p->pos = ANIM_HEADER_BYTES;
+    p->ssd = ssd;
+    return p->frames > 0;
+}
+
+bool anim_decode_frame(anim_player_t *p, uint8_t *buffer, int *first, int *last) {
+    if (p->frame >= p->frames) {
+        return false;
+    }
+    // O primeiro frame é relativo à tela apagada
+    if (p->frame == 0) {
+        memset(buffer, 0, p->frame_bytes);
+    }
+
+    *first = p->frame_bytes;
+    *last = -1;
+    size_t i = 0;
+    while (i < p->frame_bytes) {
+        if (p->pos >= p->length) {
+            return false;
+        }
+        uint8_t op = p->stream[p->pos++];
+        if (op < ANIM_OP_RUN) {
+            i += op + 1;
+            continue;
+        }
+
+        size_t count = (op & 0x3F) + 1;
+        bool literal = op >= ANIM_OP_LITERAL;
+        if (i + count > p->frame_bytes || p->pos + (literal ? count : 1) > p->length) {
+            return false;
+        }
+        const uint8_t *src = p->stream + p->pos;
+        for (size_t k = 0; k < count; k++, i++) {
+            uint8_t value = literal ? src[k] : src[0];
+            if (buffer[i] != value) {
+                buffer[i] = value;
+                *first = MIN(*first, (int)i);
+                *last = (int)i;
+            }
+        }
+        p->pos += literal ? count : 1;
+    }
+    // Um pulo que passa do fim do frame invalida o stream
+    if (i != p->frame_bytes) {
+        return false;
+    }
+    p->frame++;
+    return true;
+}
+
+bool anim_poll(anim_player_t *p) {
+    if (p->frame >= p->frames && !p->loop) {
+        return false;
+    }
+    uint64_t now = hal_time_us();
+    if ((p->shown && now < p->next_us) || ssd1306_flush_busy(p->ssd)) {
+        return true;
+    }
+
+    // Nova volta: o stream recomeça da tela apagada; o envio compara com o que
+    // o display mostra (o último frame), então só a diferença é transmitida
+    if (p->frame >= p->frames) {
+        p->frame = 0;
+        p->pos = ANIM_HEADER_BYTES;
+    }
+    int first, last;
+    if (!anim_decode_frame(p, ssd1306_buffer(p->ssd), &first, &last)) {
+        p->frame = p->frames;
+        p->loop = false;
+        return false;
+    }
+    // O primeiro frame parte da tela apagada, que o decodificador não conta
+    // como mudança: é enviado sempre, senão um início em branco deixaria no
+    // display a tela anterior. O envio só transmite o que difere do front
+    if (first <= last || p->frame == 1) {
+        uint64_t before = ssd1306_tx_stats(p->ssd->i2c_port)->bytes;
+        ssd1306_flush_async(p->ssd);
+        p->bytes += ssd1306_tx_stats(p->ssd->i2c_port)->bytes - before;
+    }
+
+    // Ritmo fixo a partir do primeiro frame; se um frame perdeu o horário do
+    // seguinte, o ritmo recomeça agora em vez de enviar frames em rajada
+    if (!p->shown) {
+        p->next_us = now;
+    } else if (now - p->next_us >= p->period_us) {
+        p->late++;
+        p->next_us = now;
+    }
+    p->next_us += p->period_us;
+    p->shown++;
+    return true;
+}
+
+void anim_play(anim_player_t *p) {
+    while (anim_poll(p)) {
+        uint64_t now = hal_time_us();
+        if (now < p->next_us) {
+            hal_sleep_us(p->next_us - now);
+        } else {
+            ssd1306_flush_wait(p->ssd);
+        }
+    }
+    ssd1306_flush_wait(p->ssd);
+}
+
+size_t anim_encode_header(uint8_t *out, uint8_t width, uint8_t pages, uint16_t frames, uint16_t period_ms) {
+    uint8_t header[ANIM_HEADER_BYTES] = {
+        anim_magic[0], anim_magic[1], ANIM_VERSION, width, pages, 0,
+        frames, frames >> 8, period_ms, period_ms >> 8
+    };
+    memcpy(out, header, sizeof(header));
+    return sizeof(header);
+}
+
+size_t anim_encode_frame(const uint8_t *prev, const uint8_t *cur, size_t length, uint8_t *out, size_t capacity) {
+    size_t o = 0;
+    size_t i = 0;
+    while (i < length) {
+        size_t count = 1;
+
+        // Trecho igual ao frame anterior: pulo
+        if (cur[i] == prev[i]) {
+            while (i + count < length && count < ANIM_SKIP_MAX && cur[i + count] == prev[i + count]) {
+                count++;
+            }
+            if (o + 1 > capacity) {
+                return 0;
+            }
+            out[o++] = (uint8_t)(count - 1);
+            i += count;
+            continue;
+        }
+
+        // Três ou mais bytes iguais: repetição
+        while (i + count < length && count < ANIM_RUN_MAX && cur[i + count] == cur[i]) {
+            count++;
+        }
+        if (count >= 3) {
+            if (o + 2 > capacity) {
+                return 0;
+            }
+            out[o++] = (uint8_t)(ANIM_OP_RUN | (count - 1));
+            out[o++] = cur[i];
+            i += count;
+            continue;
+        }
+
+        // Literais até começar um pulo de 2 bytes ou uma repetição de 3
+        count = 0;
+        while (i + count < length && count < ANIM_RUN_MAX) {
+            size_t k = i + count;
+            if (count && k + 1 < length && cur[k] == prev[k] && cur[k + 1] == prev[k + 1]) {
+                break;
+            }
+            if (count && k + 2 < length && cur[k] == cur[k + 1] && cur[k] == cur[k + 2]) {
+                break;
+            }
+            count++;
+        }
+        if (o + 1 + count > capacity) {
+            return 0;
+        }
+        out[o++] = (uint8_t)(ANIM_OP_LITERAL | (count - 1));
+        memcpy(out + o, cur + i, count);
+        o += count;
+        i += count;
+    }
+    return o;
+}
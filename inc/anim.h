@@ -0,0 +1,83 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "hal.h"
+#include "ssd1306_i2c.h"
+
+#ifndef anim_inc_h
+#define anim_inc_h
+
+//------------------------------------------------------------------------------
+// Animações comprimidas para o display ssd1306_t (caminho do bitmap)
+//------------------------------------------------------------------------------
+// Uma animação é um vetor const (fica na flash) com um cabeçalho e os frames
+// codificados em sequência. Cada frame é descrito em relação ao anterior (o
+// primeiro, em relação à tela apagada), na mesma ordem de bytes do framebuffer
+// do display: página a página, 'largura' bytes por página.
+//
+// O reprodutor decodifica cada frame direto sobre o framebuffer do display,
+// que já guarda o frame anterior, e o envia com ssd1306_flush_async, que só
+// transmite as janelas alteradas. Além dos framebuffers que o display já tem,
+// a RAM usada é a do anim_player_t. Os frames saem em ritmo fixo, contado a
+// partir do primeiro. A largura tem de ser a do framebuffer (ssd1306_width).
+//
+// Formato (inteiros little-endian):
+//   "DA" + versão (1) + largura (u8) + páginas (u8) + reservado (u8) +
+//   quantidade de frames (u16) + período em ms (u16)
+//   Cada frame é uma sequência de operações que cobre largura * páginas bytes:
+//     0x00..0x7F  pula n + 1 bytes (iguais ao frame anterior)
+//     0x80..0xBF  repete o byte seguinte (n & 0x3F) + 1 vezes
+//     0xC0..0xFF  copia os (n & 0x3F) + 1 bytes seguintes
+//------------------------------------------------------------------------------
+
+#define ANIM_HEADER_BYTES 10
+#define ANIM_VERSION 2
+// Maior frame codificado: um byte de operação a cada 64 literais
+#define ANIM_FRAME_MAX(n) ((n) + ((n) + 63) / 64)
+
+typedef struct {
+    // Animação
+    const uint8_t *stream;
+    size_t length;
+    uint16_t frames;
+    uint16_t frame_bytes; // largura * páginas
+    uint8_t pages;
+    uint32_t period_us;
+    bool loop;
+
+    // Posição atual
+    size_t pos;      // Início do próximo frame no stream
+    uint16_t frame;  // Frames já decodificados (na volta atual)
+    uint64_t next_us;
+
+    ssd1306_t *ssd;
+
+    uint32_t shown;  // Frames enviados
+    uint32_t late;   // Frames enviados depois do horário
+    uint64_t bytes;  // Bytes enviados (controle, comandos e dados)
+} anim_player_t;
+
+// Prepara a reprodução no display. Retorna false se o stream for inválido ou
+// a geometria não for a do display. O primeiro frame sai no próximo poll
+bool anim_start(anim_player_t *p, ssd1306_t *ssd, const uint8_t *stream, size_t length, bool loop);
+
+// Envia o próximo frame se chegou a hora e o barramento está livre. Não
+// bloqueia. Retorna false quando a animação terminou (ou o stream é inválido)
+bool anim_poll(anim_player_t *p);
+
+// Reproduz a animação inteira, dormindo entre os frames
+void anim_play(anim_player_t *p);
+
+// Decodifica o próximo frame sobre 'buffer'. Em *first e *last ficam o
+// primeiro e o último byte que mudaram (*first > *last se nenhum). Retorna
+// false se o stream acabou ou uma operação passaria do frame
+bool anim_decode_frame(anim_player_t *p, uint8_t *buffer, int *first, int *last);
+
+// Codificação (ferramenta e benchmark): escreve o cabeçalho e retorna o tamanho
+size_t anim_encode_header(uint8_t *out, uint8_t width, uint8_t pages, uint16_t frames, uint16_t period_ms);
+
+// Codifica 'cur' em relação a 'prev' (length bytes cada). Retorna os bytes
+// escritos em 'out', ou 0 se não couberem em 'capacity'
+size_t anim_encode_frame(const uint8_t *prev, const uint8_t *cur, size_t length, uint8_t *out, size_t capacity);
+
+#endif
@@ -0,0 +1,68 @@
+#include "fisica.h"
+
+// Variação da velocidade (casas/s) em um subpasso, para cada gravidade
+#define FISICA_DV(gravidade) FX((gravidade) * FISICA_DT_US / 1e6)
+
+void fisica_dino_init(fisica_dino_t *d)
+{
+  d->altura = 0;
+  d->velocidade = 0;
+  d->no_chao = true;
+  d->abaixado = false;
+  d->pulos = 0;
+}
+
+void __not_in_flash_func(fisica_dino_passo)(fisica_dino_t *d, bool pulo, bool abaixar)
+{
+  // No chão: abaixar tem prioridade; o pulo só sai com o botão de abaixar solto
+  if (d->no_chao)
+  {
+    d->abaixado = abaixar;
+    if (!pulo || abaixar)
+    {
+      return;
+    }
+    d->no_chao = false;
+    d->velocidade = FX(FISICA_PULO_VELOCIDADE);
+    d->pulos++;
+  }
+
+  // Euler semi-implícito: primeiro a velocidade, depois a posição
+  if (abaixar)
+  {
+    d->velocidade -= FISICA_DV(FISICA_GRAVIDADE_MERGULHO);
+  }
+  else if (pulo)
+  {
+    d->velocidade -= FISICA_DV(FISICA_GRAVIDADE_PLANANDO);
+  }
+  else
+  {
+    d->velocidade -= FISICA_DV(FISICA_GRAVIDADE);
+  }
+  d->altura += fx_mul(d->velocidade, FISICA_DT);
+
+  // Teto: o dino para de subir
+  if (d->altura > FX(FISICA_TETO))
+  {
+    d->altura = FX(FISICA_TETO);
+    d->velocidade = 0;
+  }
+
+  // Aterrissagem
+  if (d->altura <= 0)
+  {
+    d->altura = 0;
+    d->velocidade = 0;
+    d->no_chao = true;
+    d->abaixado = abaixar;
+  }
+}
+
+uint32_t __not_in_flash_func(fisica_curva_periodo_us)(const fisica_curva_t *c, uint32_t tempo_ms)
+{
+  // Redução acumulada em 64 bits: o tempo de jogo não tem limite
+  uint32_t queda = c->inicial_us - c->minimo_us;
+  uint64_t reducao = (uint64_t)c->reducao_us * tempo_ms / c->intervalo_ms;
+  return reducao >= queda ? c->minimo_us : c->inicial_us - (uint32_t)reducao;
+}
@@ -0,0 +1,100 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal.h"
+
+#ifndef fisica_inc_h
+#define fisica_inc_h
+
+//------------------------------------------------------------------------------
+// Física do jogo em ponto fixo (Q16.16)
+//------------------------------------------------------------------------------
+// O RP2040 não tem FPU: posições, velocidades e acelerações são inteiros de 32
+// bits com 16 bits de fração (fx_t), e cada subpasso custa algumas somas e uma
+// multiplicação. As distâncias são medidas em casas da matriz de LEDs; a
+// renderização arredonda o resultado para a grade.
+//
+// Cada tick lógico (FISICA_PASSO_US) é dividido em FISICA_SUBPASSOS subpassos
+// de duração fixa. A colisão é conferida em cada subpasso, então um inimigo
+// rápido não atravessa o dino entre dois ticks.
+//
+// Dino: altura acima do chão e velocidade vertical, com gravidade. O pulo é um
+// impulso para cima; segurar o botão no ar diminui a gravidade (pulo mais
+// longo) até o teto, e abaixar no ar aumenta a gravidade (mergulho).
+//
+// Inimigos: a velocidade segue uma curva contínua no tempo (o período, em
+// tempo por casa, cai linearmente até o mínimo) em vez de degraus.
+//------------------------------------------------------------------------------
+
+typedef int32_t fx_t;
+
+#define FX_FRACAO 16
+#define FX_UM ((fx_t)1 << FX_FRACAO)
+// Constante em ponto fixo (calculada na compilação)
+#define FX(x) ((fx_t)((x) * (double)FX_UM + ((x) < 0 ? -0.5 : 0.5)))
+
+static inline fx_t fx_mul(fx_t a, fx_t b)
+{
+  return (fx_t)(((int64_t)a * b) >> FX_FRACAO);
+}
+
+// Parte inteira arredondada (para a grade)
+static inline int fx_arredonda(fx_t a)
+{
+  return (a + FX_UM / 2) >> FX_FRACAO;
+}
+
+// Duração de um tick lógico e subpassos por tick
+#define FISICA_PASSO_US 10000
+#define FISICA_SUBPASSOS 4
+#define FISICA_DT_US (FISICA_PASSO_US / FISICA_SUBPASSOS)
+// Duração do subpasso em segundos
+#define FISICA_DT FX(FISICA_DT_US / 1e6)
+
+// Dino (casas e segundos)
+#define FISICA_PULO_VELOCIDADE 10.0 // Impulso do pulo (casas/s)
+#define FISICA_GRAVIDADE 80.0       // Botão solto (casas/s²)
+#define FISICA_GRAVIDADE_PLANANDO 6.0 // Botão de pulo mantido no ar
+#define FISICA_GRAVIDADE_MERGULHO 320.0 // Botão de abaixar no ar
+#define FISICA_TETO 1.25            // Altura máxima (casas)
+
+typedef struct
+{
+  fx_t altura;     // Casas acima do chão
+  fx_t velocidade; // Casas/s (positiva para cima)
+  bool no_chao;
+  bool abaixado;   // No chão com o botão de abaixar
+  uint32_t pulos;
+} fisica_dino_t;
+
+// Curva de velocidade dos inimigos: o período (tempo para andar uma casa)
+// começa em 'inicial_us' e cai 'reducao_us' a cada 'intervalo_ms' de jogo,
+// continuamente, até 'minimo_us'
+typedef struct
+{
+  uint32_t inicial_us;
+  uint32_t minimo_us;
+  uint32_t reducao_us;
+  uint32_t intervalo_ms;
+} fisica_curva_t;
+
+void fisica_dino_init(fisica_dino_t *d);
+
+// Um subpasso: pulo e abaixar são os botões mantidos
+void fisica_dino_passo(fisica_dino_t *d, bool pulo, bool abaixar);
+
+// Casas (inteiras) que o dino está acima do chão
+static inline int fisica_dino_linhas(const fisica_dino_t *d)
+{
+  return fx_arredonda(d->altura);
+}
+
+// Período dos inimigos após 'tempo_ms' de jogo
+uint32_t fisica_curva_periodo_us(const fisica_curva_t *c, uint32_t tempo_ms);
+
+// Casas andadas em um subpasso por quem anda uma casa a cada 'periodo_us'
+static inline fx_t fisica_deslocamento(uint32_t periodo_us)
+{
+  return (fx_t)(((uint32_t)FISICA_DT_US << FX_FRACAO) / periodo_us);
+}
+
+#endif
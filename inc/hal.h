@@ -0,0 +1,204 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef hal_inc_h
+#define hal_inc_h
+
+//------------------------------------------------------------------------------
+// Camada de abstração de hardware (HAL) do Dino Runner
+//------------------------------------------------------------------------------
+// O jogo e o driver do SSD1306 não chamam o Pico SDK diretamente: tudo passa
+// por estas funções. Existem duas implementações:
+//   - inc/hal_pico.c: usa GPIO, PIO, I2C e o timer reais da placa;
+//   - inc/hal_host.c: roda no Linux, grava os frames dos LEDs e do OLED em
+//     memória e usa um relógio virtual (compilada com DINO_HOST definido).
+//------------------------------------------------------------------------------
+
+#ifdef DINO_HOST
+// No host não existe o Pico SDK; definimos os poucos tipos e macros usados
+typedef unsigned int uint;
+#ifndef count_of
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#endif
+#define _u(x) x##u
+static inline void tight_loop_contents(void) {}
+// No Pico, as funções do caminho quente (interrupções, tick, passo do jogo e
+// renderização) rodam da SRAM, sem esperar pelo cache do XIP; no host não há
+// diferença
+#define __not_in_flash_func(func_name) func_name
+#ifndef MIN
+#define MIN(a, b) ((b) < (a) ? (b) : (a))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#else
+#include "pico/stdlib.h"
+#endif
+
+// Portas I2C (equivalentes a i2c0 e i2c1 do SDK)
+#define HAL_I2C0 0
+#define HAL_I2C1 1
+
+// Inicialização geral (stdio no Pico, variáveis de ambiente no host)
+void hal_init(void);
+
+// Botões: GPIO de entrada com pull-up. Retorna o nível lido no pino
+void hal_input_init(uint pin);
+bool hal_input_get(uint pin);
+// Interrupção nas bordas de subida e descida do pino: 'callback' recebe o pino,
+// o novo nível e o instante da borda em us. Um único callback atende a todos
+// os pinos; no Pico ele roda em contexto de interrupção no core que o registrou
+void hal_input_irq(uint pin, void (*callback)(uint pin, bool level, uint64_t time_us));
+
+// Matriz WS2812: cada LED é uma palavra com G, R e B nos bits 31..8. O envio
+// é assíncrono (DMA no Pico) e inclui o tempo de reset (latch) do sinal; o
+// buffer não pode ser alterado enquanto hal_np_busy() for verdadeiro
+//
+// Com lanes > 1, as fitas ficam nos pinos pin .. pin + lanes - 1 e recebem os
+// bits em paralelo. 'words' traz então HAL_NP_LANE_WORDS palavras por LED de
+// cada fita: um byte por bit de G, R e B (do mais significativo), com o bit k
+// vindo da fita k, quatro bytes por palavra a partir do byte baixo (ver
+// inc/np_lanes.h). 'count' é sempre a quantidade de LEDs de cada fita
+#define HAL_NP_FREQ 800000
+#define HAL_NP_RESET_US 100
+#define HAL_NP_LANES_MAX 8
+#define HAL_NP_LANE_WORDS 6
+void hal_np_init(uint pin, uint lanes);
+void hal_np_write_async(const uint32_t *words, size_t count);
+bool hal_np_busy(void);
+void hal_np_wait(void);
+
+// I2C: escrita bloqueante de um bloco. Retorna bytes escritos ou < 0 em erro
+// (inclusive quando o alvo não confirma o endereço)
+void hal_i2c_init(uint port, uint sda, uint scl, uint baudrate);
+int hal_i2c_write(uint port, uint8_t address, const uint8_t *src, size_t length);
+// Troca o clock da porta (sem transferência em andamento). Retorna o clock obtido
+uint hal_i2c_set_baudrate(uint port, uint baudrate);
+
+// I2C assíncrono: monta uma sequência de transações (cada append com stop
+// fecha uma) e a transmite em segundo plano, por DMA no Pico. Os bytes são
+// copiados no append, então o buffer de origem pode ser reutilizado logo depois.
+// begin retorna false se a sequência anterior ainda estiver sendo transmitida
+#define HAL_I2C_ASYNC_MAX 1088
+bool hal_i2c_async_begin(uint port, uint8_t address);
+bool hal_i2c_async_append(uint port, const uint8_t *src, size_t length, bool stop);
+void hal_i2c_async_start(uint port);
+bool hal_i2c_async_busy(uint port);
+void hal_i2c_async_wait(uint port);
+
+// Flash de dados: HAL_FLASH_SECTORS setores reservados no fim da flash, fora
+// do programa, endereçados a partir de 0. A leitura é direta (mapeada pelo XIP
+// no Pico). Apagar (setor inteiro em 0xFF) e programar (páginas inteiras; só
+// zera bits) param o XIP por milissegundos: no Pico rodam da RAM, com as
+// interrupções desligadas e o outro núcleo parado, então não devem ser
+// chamadas no loop do jogo. Retornam false com endereço inválido ou se o outro
+// núcleo não parou a tempo
+#define HAL_FLASH_SECTOR_SIZE 4096
+#define HAL_FLASH_PAGE_SIZE 256
+#define HAL_FLASH_SECTORS 4
+#define HAL_FLASH_BYTES (HAL_FLASH_SECTORS * HAL_FLASH_SECTOR_SIZE)
+const uint8_t *hal_flash_data(void);
+bool hal_flash_erase(uint32_t offset);
+bool hal_flash_program(uint32_t offset, const uint8_t *src, size_t length);
+
+// Serial (USB CDC do stdio no Pico): escrita de bytes crus, sem bloquear. Aceita
+// só o que cabe agora no buffer de transmissão e retorna quantos bytes foram
+// aceitos (0 sem um host conectado). O USB interrompe o núcleo a cada quadro
+// de 1 ms, então quem espera em hal_wait_event pode continuar o envio nesse ritmo
+size_t hal_serial_write(const uint8_t *src, size_t length);
+
+// Relógio: microssegundos desde o boot e esperas
+uint64_t hal_time_us(void);
+void hal_sleep_us(uint64_t us);
+void hal_sleep_ms(uint32_t ms);
+
+// Contador de ciclos para medir trechos curtos: a diferença entre duas leituras,
+// mascarada com HAL_CYCLES_MASK, é o tempo decorrido em ciclos. No Pico é o
+// SysTick (24 bits, um por núcleo, ~134 ms a 125 MHz antes de dar a volta); no
+// host são nanossegundos do relógio monotônico real, não do relógio virtual
+#ifdef DINO_HOST
+#define HAL_CYCLES_MASK 0xFFFFFFFFu
+#else
+#define HAL_CYCLES_MASK 0x00FFFFFFu
+#endif
+uint32_t hal_cycles(void);
+uint32_t hal_cycles_per_us(void);
+
+// Timer periódico: chama 'callback' a cada period_us, em ritmo fixo (em
+// interrupção no Pico). Só existe um timer; uma nova chamada o substitui
+void hal_timer_start(uint32_t period_us, void (*callback)(void));
+// Dorme até o próximo evento (interrupção); no host avança até o próximo tick
+void hal_wait_event(void);
+// Acorda quem estiver em hal_wait_event no outro núcleo (SEV)
+void hal_signal_event(void);
+// Roda 'entry' no core 1. Retorna false se não houver segundo núcleo (host):
+// nesse caso o chamador executa o trabalho no próprio loop
+bool hal_launch_core1(void (*entry)(void));
+// Seção crítica curta contra o callback do timer
+uint32_t hal_irq_disable(void);
+void hal_irq_restore(uint32_t state);
+
+#ifdef DINO_HOST
+//------------------------------------------------------------------------------
+// Inspeção do backend host (não existe no Pico)
+//------------------------------------------------------------------------------
+
+// Maior frame de LEDs aceito pelo gravador (em bytes): o máximo de 2047 LEDs
+// da matriz (inc/np_geometry.h), para nenhuma configuração ser truncada
+#define HAL_HOST_LED_MAX_BYTES (2047 * 3)
+// Quantidade de frames mantidos em memória (buffers circulares): 256 frames de
+// LEDs ocupam 1,5 MB, o que é aceitável para o host
+#define HAL_HOST_LED_FRAMES 256
+#define HAL_HOST_OLED_FRAMES 32
+// Tamanho da GDDRAM emulada do SSD1306 (128x64, 8 páginas)
+#define HAL_HOST_OLED_BYTES 1024
+
+typedef struct {
+  uint64_t time_us;
+  size_t length;
+  uint8_t grb[HAL_HOST_LED_MAX_BYTES];
+} hal_host_led_frame_t;
+
+typedef struct {
+  uint64_t time_us;
+  uint port;
+  uint8_t gddram[HAL_HOST_OLED_BYTES];
+} hal_host_oled_frame_t;
+
+typedef struct {
+  uint32_t transactions;
+  uint64_t bytes;
+} hal_host_i2c_stats_t;
+
+typedef struct {
+  uint32_t erases[HAL_FLASH_SECTORS]; // Apagamentos de cada setor
+  uint32_t pages;                     // Páginas programadas
+  uint64_t stall_us;                  // Tempo com o XIP parado
+} hal_host_flash_stats_t;
+
+// Define o nível de um pino de entrada (1 = solto, 0 = pressionado)
+void hal_host_set_input(uint pin, bool level);
+
+// Total de frames gravados e acesso ao frame 'age' (0 = mais recente)
+uint64_t hal_host_led_frame_count(void);
+const hal_host_led_frame_t *hal_host_led_frame(uint age);
+uint64_t hal_host_oled_frame_count(void);
+const hal_host_oled_frame_t *hal_host_oled_frame(uint age);
+
+// Conteúdo atual da GDDRAM emulada do display na porta indicada
+const uint8_t *hal_host_oled_gddram(uint port);
+
+// Contadores de tráfego I2C por porta
+hal_host_i2c_stats_t hal_host_i2c_stats(uint port);
+
+// Contadores da flash de dados emulada
+hal_host_flash_stats_t hal_host_flash_stats(void);
+
+// Volta o backend ao estado inicial (relógio, gravações e entradas); a flash
+// de dados é mantida, como numa placa reiniciada
+void hal_host_reset(void);
+#endif
+
+#endif
@@ -0,0 +1,756 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal.h"
+
+//------------------------------------------------------------------------------
+// Backend host da HAL: roda o jogo como executável Linux
+//------------------------------------------------------------------------------
+// - O relógio é virtual: hal_sleep_* apenas avança o tempo, então uma partida
+//   inteira roda em milissegundos e sempre da mesma forma.
+// - Os bytes enviados aos LEDs viram frames gravados num buffer circular.
+// - Cada porta I2C tem um SSD1306 emulado (comandos + GDDRAM); cada escrita de
+//   dados gera uma cópia da GDDRAM no buffer circular de frames do OLED. A
+//   rolagem horizontal contínua gira a GDDRAM conforme o relógio virtual, a um
+//   quadro do display a cada HAL_HOST_OLED_FRAME_US.
+// - A flash de dados é um vetor em RAM com a semântica de uma NOR (apagar leva
+//   o setor a 0xFF, programar só zera bits). Cada operação para o relógio
+//   virtual pelo tempo típico de um W25Q16, sem disparar o timer, como o XIP
+//   parado com as interrupções desligadas no Pico.
+//
+// Configuração por variáveis de ambiente (lidas em hal_init):
+//   DINO_HOST_INPUT=arquivo  roteiro de entradas, uma linha "<ms> <pino> <nível>"
+//   DINO_HOST_DUMP=arquivo   grava os frames capturados ao final da execução
+//   DINO_HOST_MAX_MS=n       encerra o processo quando o relógio passar de n ms
+//   DINO_HOST_I2C_MAX_HZ=n   maior clock aceito pelos displays; acima dele as
+//                            transações não são confirmadas (sem limite se ausente)
+//   DINO_HOST_SERIAL=arquivo grava os bytes da serial (telemetria). A serial
+//                            imita o USB CDC: um FIFO de HAL_HOST_SERIAL_FIFO
+//                            bytes esvaziado a cada quadro de 1 ms, que também
+//                            acorda hal_wait_event; sem o arquivo, nada é aceito
+//   DINO_HOST_FLASH=arquivo  conteúdo da flash de dados, lido no início e
+//                            regravado a cada operação (entre execuções)
+//------------------------------------------------------------------------------
+
+#define HAL_HOST_PINS 32
+#define HAL_HOST_I2C_PORTS 2
+#define HAL_HOST_OLED_PAGES 8
+#define HAL_HOST_OLED_COLUMNS 128
+// Quadro do display com o divisor de clock padrão (~100 Hz)
+#define HAL_HOST_OLED_FRAME_US 10000
+// Tempos típicos da flash: apagar um setor e programar uma página
+#define HAL_HOST_FLASH_ERASE_US 45000
+#define HAL_HOST_FLASH_PAGE_US 700
+// FIFO de transmissão do USB CDC (TinyUSB do SDK) e quadro USB
+#define HAL_HOST_SERIAL_FIFO 256
+#define HAL_HOST_SERIAL_FRAME_US 1000
+
+typedef struct {
+    uint64_t time_us;
+    uint pin;
+    bool level;
+} hal_host_input_event_t;
+
+// Estado do controlador SSD1306 emulado em uma porta I2C
+typedef struct {
+    uint8_t gddram[HAL_HOST_OLED_BYTES];
+    uint8_t memory_mode;  // 0 = horizontal, 1 = vertical, 2 = página
+    uint8_t col_start, col_end, col;
+    uint8_t page_start, page_end, page;
+    uint8_t command;      // Comando aguardando argumentos
+    uint8_t args[6];
+    uint8_t args_needed, args_count;
+    // Rolagem horizontal: páginas, passo em quadros e instante do último passo
+    bool scroll_active, scroll_left;
+    uint8_t scroll_start_page, scroll_end_page;
+    uint16_t scroll_frames;
+    uint64_t scroll_time_us;
+} hal_host_oled_t;
+
+static uint64_t now_us;
+static uint64_t max_us;
+static bool inputs[HAL_HOST_PINS];
+
+static void (*input_callback)(uint pin, bool level, uint64_t time_us);
+
+static hal_host_input_event_t *script;
+static size_t script_length, script_next;
+
+static hal_host_led_frame_t led_frames[HAL_HOST_LED_FRAMES];
+static uint64_t led_frame_count;
+static uint64_t np_done_us;
+// Fitas da saída paralela (1: uma palavra GRB por LED)
+static uint np_lanes = 1;
+static hal_host_oled_frame_t oled_frames[HAL_HOST_OLED_FRAMES];
+static uint64_t oled_frame_count;
+
+// Sequência assíncrona: transação em montagem e fim simulado da transmissão
+typedef struct {
+    uint8_t pending[HAL_I2C_ASYNC_MAX];
+    size_t pending_length;
+    size_t queued;
+    uint64_t done_us;
+} hal_host_i2c_async_t;
+
+static hal_host_oled_t oleds[HAL_HOST_I2C_PORTS];
+static hal_host_i2c_async_t i2c_async[HAL_HOST_I2C_PORTS];
+static hal_host_i2c_stats_t i2c_stats[HAL_HOST_I2C_PORTS];
+static uint i2c_baudrate[HAL_HOST_I2C_PORTS];
+static uint i2c_max_hz;
+
+static const char *dump_path;
+
+static uint8_t flash[HAL_FLASH_BYTES];
+static hal_host_flash_stats_t flash_stats;
+static const char *flash_path;
+
+static FILE *serial_file;
+static uint64_t serial_frame;
+static size_t serial_fifo;
+
+// Timer periódico, disparado conforme o relógio virtual avança
+static uint32_t timer_period_us;
+static uint64_t timer_next_us;
+static void (*timer_callback)(void);
+
+// Muda o nível de um pino e, se houver borda, chama o callback de interrupção
+static void hal_host_input_edge(uint pin, bool level, uint64_t time_us) {
+    if (pin >= HAL_HOST_PINS || inputs[pin] == level) {
+        return;
+    }
+    inputs[pin] = level;
+    if (input_callback) {
+        input_callback(pin, level, time_us);
+    }
+}
+
+// Aplica os eventos do roteiro de entradas cujo tempo já foi alcançado. A borda
+// leva o instante do roteiro, como a interrupção no Pico
+static void hal_host_apply_script(void) {
+    while (script_next < script_length && script[script_next].time_us <= now_us) {
+        hal_host_input_edge(script[script_next].pin, script[script_next].level, script[script_next].time_us);
+        script_next++;
+    }
+}
+
+static void hal_host_load_script(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "hal_host: não foi possível abrir %s\n", path);
+        exit(1);
+    }
+
+    size_t capacity = 0;
+    unsigned long long ms;
+    unsigned pin, level;
+    while (fscanf(file, "%llu %u %u", &ms, &pin, &level) == 3) {
+        if (script_length == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            script = realloc(script, capacity * sizeof(*script));
+        }
+        script[script_length].time_us = ms * 1000;
+        script[script_length].pin = pin;
+        script[script_length].level = level != 0;
+        script_length++;
+    }
+    fclose(file);
+}
+
+static void hal_host_dump(void) {
+    FILE *file = fopen(dump_path, "w");
+    if (!file) {
+        return;
+    }
+
+    uint64_t leds = led_frame_count < HAL_HOST_LED_FRAMES ? led_frame_count : HAL_HOST_LED_FRAMES;
+    for (uint age = (uint)leds; age-- > 0;) {
+        const hal_host_led_frame_t *frame = hal_host_led_frame(age);
+        fprintf(file, "led %llu %llu ", (unsigned long long)(led_frame_count - 1 - age),
+                (unsigned long long)frame->time_us);
+        for (size_t i = 0; i < frame->length; i++) {
+            fprintf(file, "%02x", frame->grb[i]);
+        }
+        fputc('\n', file);
+    }
+
+    for (uint port = 0; port < HAL_HOST_I2C_PORTS; port++) {
+        fprintf(file, "i2c %u %u %llu\n", port, i2c_stats[port].transactions,
+                (unsigned long long)i2c_stats[port].bytes);
+    }
+
+    const hal_host_oled_frame_t *oled = hal_host_oled_frame(0);
+    if (oled) {
+        fprintf(file, "oled %llu %llu %u\n", (unsigned long long)(oled_frame_count - 1),
+                (unsigned long long)oled->time_us, oled->port);
+        for (int y = 0; y < HAL_HOST_OLED_PAGES * 8; y++) {
+            for (int x = 0; x < HAL_HOST_OLED_COLUMNS; x++) {
+                uint8_t byte = oled->gddram[(y / 8) * HAL_HOST_OLED_COLUMNS + x];
+                fputc(byte & (1 << (y % 8)) ? '#' : '.', file);
+            }
+            fputc('\n', file);
+        }
+    }
+    fclose(file);
+}
+
+static void hal_host_flash_load(void) {
+    memset(flash, 0xFF, sizeof(flash));
+    flash_path = getenv("DINO_HOST_FLASH");
+    FILE *file = flash_path ? fopen(flash_path, "rb") : NULL;
+    if (file) {
+        size_t length = fread(flash, 1, sizeof(flash), file);
+        (void)length;
+        fclose(file);
+    }
+}
+
+static void hal_host_flash_save(void) {
+    FILE *file = flash_path ? fopen(flash_path, "wb") : NULL;
+    if (file) {
+        fwrite(flash, 1, sizeof(flash), file);
+        fclose(file);
+    }
+}
+
+void hal_init(void) {
+    static bool configured;
+    if (configured) {
+        return;
+    }
+    configured = true;
+
+    // Pull-ups: todos os pinos ficam em nível alto até o roteiro dizer o contrário
+    memset(inputs, 1, sizeof(inputs));
+
+    const char *input = getenv("DINO_HOST_INPUT");
+    if (input) {
+        hal_host_load_script(input);
+        hal_host_apply_script();
+    }
+
+    const char *max_ms = getenv("DINO_HOST_MAX_MS");
+    if (max_ms) {
+        max_us = strtoull(max_ms, NULL, 10) * 1000;
+    }
+
+    const char *i2c_max = getenv("DINO_HOST_I2C_MAX_HZ");
+    if (i2c_max) {
+        i2c_max_hz = (uint)strtoul(i2c_max, NULL, 10);
+    }
+
+    hal_host_flash_load();
+
+    const char *serial = getenv("DINO_HOST_SERIAL");
+    if (serial) {
+        serial_file = fopen(serial, "wb");
+        if (!serial_file) {
+            fprintf(stderr, "hal_host: não foi possível abrir %s\n", serial);
+            exit(1);
+        }
+    }
+
+    dump_path = getenv("DINO_HOST_DUMP");
+    if (dump_path) {
+        atexit(hal_host_dump);
+    }
+}
+
+void hal_input_init(uint pin) {
+    // O pull-up já é aplicado em hal_init
+    (void)pin;
+}
+
+bool hal_input_get(uint pin) {
+    return pin < HAL_HOST_PINS ? inputs[pin] : true;
+}
+
+void hal_input_irq(uint pin, void (*callback)(uint pin, bool level, uint64_t time_us)) {
+    (void)pin;
+    input_callback = callback;
+}
+
+void hal_np_init(uint pin, uint lanes) {
+    (void)pin;
+    np_lanes = lanes;
+}
+
+// Saída paralela: cada fita lê o seu bit em cada byte das palavras da PIO, como
+// os WS2812 no fio, e o LED volta à sua posição na cadeia
+static void hal_np_emulate_lanes(const uint32_t *words, size_t count, uint8_t *grb) {
+    for (uint k = 0; k < np_lanes; k++) {
+        for (size_t i = 0; i < count; i++) {
+            uint32_t led = 0;
+            for (uint bit = 0; bit < 24; bit++) {
+                uint32_t word = words[i * HAL_NP_LANE_WORDS + bit / 4];
+                led = led << 1 | ((word >> (8 * (bit % 4) + k)) & 1);
+            }
+            uint8_t *out = grb + (k * count + i) * 3;
+            out[0] = led >> 16;
+            out[1] = led >> 8;
+            out[2] = led;
+        }
+    }
+}
+
+void hal_np_write_async(const uint32_t *words, size_t count) {
+    hal_np_wait();
+
+    hal_host_led_frame_t *frame = &led_frames[led_frame_count % HAL_HOST_LED_FRAMES];
+    size_t leds = count * np_lanes;
+    if (leds * 3 > HAL_HOST_LED_MAX_BYTES) {
+        leds = HAL_HOST_LED_MAX_BYTES / 3;
+        count = leds / np_lanes;
+        leds = count * np_lanes;
+    }
+    frame->time_us = now_us;
+    frame->length = leds * 3;
+    if (np_lanes > 1) {
+        hal_np_emulate_lanes(words, count, frame->grb);
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            frame->grb[i * 3] = words[i] >> 24;
+            frame->grb[i * 3 + 1] = words[i] >> 16;
+            frame->grb[i * 3 + 2] = words[i] >> 8;
+        }
+    }
+    led_frame_count++;
+
+    // 24 bits por LED de cada fita a 800kHz, com a folga de um LED, mais o
+    // tempo de reset, como no Pico
+    np_done_us = now_us + (uint64_t)(count + 1) * 24 * 1000000 / HAL_NP_FREQ + HAL_NP_RESET_US;
+}
+
+bool hal_np_busy(void) {
+    return now_us < np_done_us;
+}
+
+void hal_np_wait(void) {
+    if (hal_np_busy()) {
+        hal_sleep_us(np_done_us - now_us);
+    }
+}
+
+void hal_i2c_init(uint port, uint sda, uint scl, uint baudrate) {
+    (void)sda;
+    (void)scl;
+    if (port < HAL_HOST_I2C_PORTS) {
+        i2c_baudrate[port] = baudrate;
+        hal_host_oled_t *oled = &oleds[port];
+        memset(oled, 0, sizeof(*oled));
+        oled->col_end = HAL_HOST_OLED_COLUMNS - 1;
+        oled->page_end = HAL_HOST_OLED_PAGES - 1;
+        oled->memory_mode = 2;
+    }
+}
+
+// Quantidade de argumentos que seguem cada comando do SSD1306
+static uint8_t hal_host_oled_args(uint8_t command) {
+    switch (command) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+// Aplica os passos de rolagem vencidos até o instante atual
+static void hal_host_oled_scroll(hal_host_oled_t *oled) {
+    if (!oled->scroll_active) {
+        return;
+    }
+    uint64_t step_us = (uint64_t)oled->scroll_frames * HAL_HOST_OLED_FRAME_US;
+    uint64_t steps = (now_us - oled->scroll_time_us) / step_us;
+    oled->scroll_time_us += steps * step_us;
+
+    uint shift = (uint)(steps % HAL_HOST_OLED_COLUMNS);
+    if (oled->scroll_left) {
+        shift = (HAL_HOST_OLED_COLUMNS - shift) % HAL_HOST_OLED_COLUMNS;
+    }
+    if (!shift) {
+        return;
+    }
+    // Para a direita, a coluna c vai para c + shift (e a última volta ao início)
+    for (uint page = oled->scroll_start_page; page <= oled->scroll_end_page; page++) {
+        uint8_t row[HAL_HOST_OLED_COLUMNS];
+        uint8_t *gddram = oled->gddram + page * HAL_HOST_OLED_COLUMNS;
+        for (uint col = 0; col < HAL_HOST_OLED_COLUMNS; col++) {
+            row[(col + shift) % HAL_HOST_OLED_COLUMNS] = gddram[col];
+        }
+        memcpy(gddram, row, sizeof(row));
+    }
+}
+
+static void hal_host_oled_execute(hal_host_oled_t *oled) {
+    // Intervalo da rolagem (em quadros) para cada código do comando 0x26/0x27
+    static const uint16_t scroll_frames[8] = {5, 64, 128, 256, 3, 4, 25, 2};
+
+    switch (oled->command) {
+    case 0x20:
+        oled->memory_mode = oled->args[0] & 0x03;
+        break;
+    case 0x21:
+        oled->col_start = oled->args[0] & 0x7F;
+        oled->col_end = oled->args[1] & 0x7F;
+        oled->col = oled->col_start;
+        break;
+    case 0x22:
+        oled->page_start = oled->args[0] & 0x07;
+        oled->page_end = oled->args[1] & 0x07;
+        oled->page = oled->page_start;
+        break;
+    case 0x26: case 0x27:
+        oled->scroll_left = oled->command == 0x27;
+        oled->scroll_start_page = oled->args[1] & 0x07;
+        oled->scroll_frames = scroll_frames[oled->args[2] & 0x07];
+        oled->scroll_end_page = oled->args[3] & 0x07;
+        break;
+    case 0x2E:
+        oled->scroll_active = false;
+        break;
+    case 0x2F:
+        oled->scroll_active = oled->scroll_frames && oled->scroll_start_page <= oled->scroll_end_page;
+        oled->scroll_time_us = now_us;
+        break;
+    default:
+        if (oled->command >= 0xB0 && oled->command <= 0xB7) {
+            oled->page = oled->command & 0x07;
+        } else if (oled->command <= 0x0F) {
+            oled->col = (oled->col & 0xF0) | oled->command;
+        } else if (oled->command >= 0x10 && oled->command <= 0x17) {
+            oled->col = (uint8_t)((oled->col & 0x0F) | ((oled->command & 0x07) << 4));
+        }
+        break;
+    }
+}
+
+static void hal_host_oled_command(hal_host_oled_t *oled, uint8_t byte) {
+    if (oled->args_needed > oled->args_count) {
+        oled->args[oled->args_count++] = byte;
+    } else {
+        oled->command = byte;
+        oled->args_needed = hal_host_oled_args(byte);
+        oled->args_count = 0;
+    }
+    if (oled->args_count == oled->args_needed) {
+        hal_host_oled_execute(oled);
+        oled->args_needed = oled->args_count = 0;
+    }
+}
+
+// Escreve um byte na GDDRAM e avança o ponteiro conforme o modo de endereçamento
+static void hal_host_oled_data(hal_host_oled_t *oled, uint8_t byte) {
+    oled->gddram[(oled->page & 0x07) * HAL_HOST_OLED_COLUMNS + (oled->col & 0x7F)] = byte;
+
+    if (oled->memory_mode == 0) {
+        if (oled->col++ >= oled->col_end) {
+            oled->col = oled->col_start;
+            oled->page = oled->page >= oled->page_end ? oled->page_start : oled->page + 1;
+        }
+    } else if (oled->memory_mode == 1) {
+        if (oled->page++ >= oled->page_end) {
+            oled->page = oled->page_start;
+            oled->col = oled->col >= oled->col_end ? oled->col_start : oled->col + 1;
+        }
+    } else {
+        oled->col = (oled->col + 1) & 0x7F;
+    }
+}
+
+// Aplica uma transação completa ao SSD1306 emulado da porta. Retorna false se
+// o display não a confirmou (clock acima de DINO_HOST_I2C_MAX_HZ)
+static bool hal_host_i2c_transaction(uint port, const uint8_t *src, size_t length) {
+    if (i2c_max_hz && i2c_baudrate[port] > i2c_max_hz) {
+        return false;
+    }
+    i2c_stats[port].transactions++;
+    i2c_stats[port].bytes += length;
+
+    // Byte de controle: bit 7 (Co) = só mais um byte, bit 6 (D/C) = dados
+    hal_host_oled_t *oled = &oleds[port];
+    bool wrote_data = false;
+    hal_host_oled_scroll(oled);
+    size_t i = 0;
+    while (i < length) {
+        uint8_t control = src[i++];
+        bool data = control & 0x40;
+        size_t end = control & 0x80 ? (i < length ? i + 1 : i) : length;
+        for (; i < end; i++) {
+            if (data) {
+                hal_host_oled_data(oled, src[i]);
+                wrote_data = true;
+            } else {
+                hal_host_oled_command(oled, src[i]);
+            }
+        }
+    }
+
+    if (wrote_data) {
+        hal_host_oled_frame_t *frame = &oled_frames[oled_frame_count % HAL_HOST_OLED_FRAMES];
+        frame->time_us = now_us;
+        frame->port = port;
+        memcpy(frame->gddram, oled->gddram, HAL_HOST_OLED_BYTES);
+        oled_frame_count++;
+    }
+    return true;
+}
+
+// Tempo de barramento: ~9 bits por byte (8 de dados + ACK)
+static uint64_t hal_host_i2c_time_us(uint port, size_t length) {
+    return i2c_baudrate[port] ? (uint64_t)length * 9 * 1000000 / i2c_baudrate[port] : 0;
+}
+
+int hal_i2c_write(uint port, uint8_t address, const uint8_t *src, size_t length) {
+    (void)address;
+    if (port >= HAL_HOST_I2C_PORTS) {
+        return -1;
+    }
+
+    hal_i2c_async_wait(port);
+    if (!hal_host_i2c_transaction(port, src, length)) {
+        // Sem ACK, a transferência para no byte de endereço
+        hal_sleep_us(hal_host_i2c_time_us(port, 1));
+        return -1;
+    }
+    hal_sleep_us(hal_host_i2c_time_us(port, length));
+    return (int)length;
+}
+
+uint hal_i2c_set_baudrate(uint port, uint baudrate) {
+    if (port >= HAL_HOST_I2C_PORTS) {
+        return 0;
+    }
+    hal_i2c_async_wait(port);
+    i2c_baudrate[port] = baudrate;
+    return baudrate;
+}
+
+bool hal_i2c_async_begin(uint port, uint8_t address) {
+    (void)address;
+    if (port >= HAL_HOST_I2C_PORTS || hal_i2c_async_busy(port)) {
+        return false;
+    }
+    i2c_async[port].pending_length = 0;
+    i2c_async[port].queued = 0;
+    return true;
+}
+
+// As transações são aplicadas ao display emulado assim que fecham; só o tempo
+// de barramento é simulado em segundo plano (até done_us)
+bool hal_i2c_async_append(uint port, const uint8_t *src, size_t length, bool stop) {
+    hal_host_i2c_async_t *async = &i2c_async[port];
+    if (async->queued + length > HAL_I2C_ASYNC_MAX) {
+        return false;
+    }
+    memcpy(async->pending + async->pending_length, src, length);
+    async->pending_length += length;
+    async->queued += length;
+    if (stop) {
+        hal_host_i2c_transaction(port, async->pending, async->pending_length);
+        async->pending_length = 0;
+    }
+    return true;
+}
+
+void hal_i2c_async_start(uint port) {
+    hal_host_i2c_async_t *async = &i2c_async[port];
+    async->done_us = now_us + hal_host_i2c_time_us(port, async->queued);
+}
+
+bool hal_i2c_async_busy(uint port) {
+    return port < HAL_HOST_I2C_PORTS && now_us < i2c_async[port].done_us;
+}
+
+void hal_i2c_async_wait(uint port) {
+    if (hal_i2c_async_busy(port)) {
+        hal_sleep_us(i2c_async[port].done_us - now_us);
+    }
+}
+
+const uint8_t *hal_flash_data(void) {
+    return flash;
+}
+
+// XIP parado: o relógio anda, mas o timer só é atendido depois
+static void hal_host_flash_stall(uint64_t us) {
+    now_us += us;
+    flash_stats.stall_us += us;
+}
+
+bool hal_flash_erase(uint32_t offset) {
+    if (offset % HAL_FLASH_SECTOR_SIZE || offset >= HAL_FLASH_BYTES) {
+        return false;
+    }
+    memset(flash + offset, 0xFF, HAL_FLASH_SECTOR_SIZE);
+    flash_stats.erases[offset / HAL_FLASH_SECTOR_SIZE]++;
+    hal_host_flash_stall(HAL_HOST_FLASH_ERASE_US);
+    hal_host_flash_save();
+    return true;
+}
+
+bool hal_flash_program(uint32_t offset, const uint8_t *src, size_t length) {
+    if (offset % HAL_FLASH_PAGE_SIZE || length % HAL_FLASH_PAGE_SIZE || offset + length > HAL_FLASH_BYTES) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        flash[offset + i] &= src[i];
+    }
+    flash_stats.pages += length / HAL_FLASH_PAGE_SIZE;
+    hal_host_flash_stall(length / HAL_FLASH_PAGE_SIZE * HAL_HOST_FLASH_PAGE_US);
+    hal_host_flash_save();
+    return true;
+}
+
+size_t hal_serial_write(const uint8_t *src, size_t length) {
+    if (!serial_file) {
+        return 0;
+    }
+    // A cada quadro USB o FIFO é esvaziado
+    uint64_t frame = now_us / HAL_HOST_SERIAL_FRAME_US;
+    if (frame != serial_frame) {
+        serial_frame = frame;
+        serial_fifo = 0;
+    }
+    size_t n = MIN(length, HAL_HOST_SERIAL_FIFO - serial_fifo);
+    fwrite(src, 1, n, serial_file);
+    fflush(serial_file);
+    serial_fifo += n;
+    return n;
+}
+
+uint64_t hal_time_us(void) {
+    return now_us;
+}
+
+void hal_sleep_us(uint64_t us) {
+    uint64_t target = now_us + us;
+
+    // Dispara o timer em cada vencimento dentro do intervalo, como a interrupção
+    while (timer_callback && timer_next_us <= target) {
+        now_us = timer_next_us;
+        timer_next_us += timer_period_us;
+        hal_host_apply_script();
+        timer_callback();
+    }
+    now_us = target;
+    hal_host_apply_script();
+    if (max_us && now_us > max_us) {
+        exit(0);
+    }
+}
+
+void hal_sleep_ms(uint32_t ms) {
+    hal_sleep_us((uint64_t)ms * 1000);
+}
+
+uint32_t hal_cycles(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+uint32_t hal_cycles_per_us(void) {
+    return 1000;
+}
+
+void hal_timer_start(uint32_t period_us, void (*callback)(void)) {
+    timer_period_us = period_us;
+    timer_next_us = now_us + period_us;
+    timer_callback = period_us ? callback : NULL;
+}
+
+void hal_wait_event(void) {
+    // O evento do host é o timer: avança o relógio até ele. Com a serial
+    // aberta, o quadro USB de 1 ms também acorda
+    if (timer_callback) {
+        uint64_t target = timer_next_us;
+        if (serial_file) {
+            target = MIN(target, (now_us / HAL_HOST_SERIAL_FRAME_US + 1) * HAL_HOST_SERIAL_FRAME_US);
+        }
+        hal_sleep_us(target - now_us);
+    }
+}
+
+void hal_signal_event(void) {
+}
+
+bool hal_launch_core1(void (*entry)(void)) {
+    // Sem segundo núcleo: mantém a execução determinística em uma só thread
+    (void)entry;
+    return false;
+}
+
+uint32_t hal_irq_disable(void) {
+    return 0;
+}
+
+void hal_irq_restore(uint32_t state) {
+    (void)state;
+}
+
+void hal_host_set_input(uint pin, bool level) {
+    hal_host_input_edge(pin, level, now_us);
+}
+
+uint64_t hal_host_led_frame_count(void) {
+    return led_frame_count;
+}
+
+const hal_host_led_frame_t *hal_host_led_frame(uint age) {
+    if (age >= led_frame_count || age >= HAL_HOST_LED_FRAMES) {
+        return NULL;
+    }
+    return &led_frames[(led_frame_count - 1 - age) % HAL_HOST_LED_FRAMES];
+}
+
+uint64_t hal_host_oled_frame_count(void) {
+    return oled_frame_count;
+}
+
+const hal_host_oled_frame_t *hal_host_oled_frame(uint age) {
+    if (age >= oled_frame_count || age >= HAL_HOST_OLED_FRAMES) {
+        return NULL;
+    }
+    return &oled_frames[(oled_frame_count - 1 - age) % HAL_HOST_OLED_FRAMES];
+}
+
+const uint8_t *hal_host_oled_gddram(uint port) {
+    if (port >= HAL_HOST_I2C_PORTS) {
+        return NULL;
+    }
+    hal_host_oled_scroll(&oleds[port]);
+    return oleds[port].gddram;
+}
+
+hal_host_i2c_stats_t hal_host_i2c_stats(uint port) {
+    hal_host_i2c_stats_t empty = {0};
+    return port < HAL_HOST_I2C_PORTS ? i2c_stats[port] : empty;
+}
+
+hal_host_flash_stats_t hal_host_flash_stats(void) {
+    return flash_stats;
+}
+
+void hal_host_reset(void) {
+    now_us = 0;
+    script_next = 0;
+    memset(inputs, 1, sizeof(inputs));
+    led_frame_count = oled_frame_count = 0;
+    np_done_us = 0;
+    timer_callback = NULL;
+    input_callback = NULL;
+    memset(i2c_stats, 0, sizeof(i2c_stats));
+    memset(i2c_async, 0, sizeof(i2c_async));
+    for (uint port = 0; port < HAL_HOST_I2C_PORTS; port++) {
+        hal_i2c_init(port, 0, 0, i2c_baudrate[port]);
+    }
+    hal_host_apply_script();
+}
@@ -0,0 +1,354 @@
+#include "pico/stdlib.h"
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+#include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "hardware/structs/systick.h"
+#include "pico/multicore.h"
+#include "pico/flash.h"
+#include "pico/stdio_usb.h"
+#include "pico/stdio/driver.h"
+#include "tusb.h"
+
+#include "hal.h"
+#include "ws2818b.pio.h" // Programa PIO para controlar os LEDs RGB
+
+// Variáveis para trabalhar com PIO
+static PIO np_pio;
+static uint np_sm;
+// Fitas em paralelo (1: programa ws2818b, uma palavra GRB por LED)
+static uint np_lanes;
+// Canal DMA que alimenta a FIFO da state machine com as palavras GRB
+static uint np_dma_channel;
+// Fim do envio mais o tempo de reset dos WS2812: ocupado até lá
+static absolute_time_t np_fim;
+
+// Sequência assíncrona de uma porta I2C. Cada byte vira uma palavra de 16 bits
+// para o IC_DATA_CMD: escritas de 8 bits são replicadas em todas as faixas do
+// barramento e ligariam os bits de comando/STOP/RESTART do registrador
+typedef struct {
+    uint16_t words[HAL_I2C_ASYNC_MAX];
+    size_t count;
+    uint8_t address;
+    uint dma_channel;
+} hal_i2c_async_t;
+
+static hal_i2c_async_t i2c_async[2];
+
+// Callback de borda dos pinos de entrada
+static void (*input_callback)(uint pin, bool level, uint64_t time_us);
+
+// Timer periódico do jogo
+static repeating_timer_t timer;
+static void (*timer_callback)(void);
+
+// Flash de dados: os últimos setores da flash
+#define HAL_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - HAL_FLASH_BYTES)
+// Tempo máximo para o outro núcleo parar antes de uma operação na flash
+#define HAL_FLASH_LOCKOUT_MS 100
+
+typedef struct {
+    uint32_t offset;
+    const uint8_t *src;
+    size_t length;
+} hal_flash_op_t;
+
+// Entrada do core 1 (chamada depois de prepará-lo para as escritas na flash)
+static void (*core1_entry)(void);
+
+// Converte o número da porta no periférico do SDK
+static i2c_inst_t *hal_i2c_inst(uint port) {
+    return port == HAL_I2C0 ? i2c0 : i2c1;
+}
+
+void hal_init(void) {
+    // Habilita entrada/saída padrão
+    stdio_init_all();
+}
+
+void hal_input_init(uint pin) {
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_IN);
+    gpio_pull_up(pin);
+}
+
+bool hal_input_get(uint pin) {
+    return gpio_get(pin);
+}
+
+static void __not_in_flash_func(hal_gpio_irq)(uint gpio, uint32_t events) {
+    uint64_t time_us = time_us_64();
+    // Com as duas bordas pendentes (trepidação rápida), vale o nível atual
+    bool level = events & GPIO_IRQ_EDGE_RISE;
+    if ((events & GPIO_IRQ_EDGE_RISE) && (events & GPIO_IRQ_EDGE_FALL)) {
+        level = gpio_get(gpio);
+    }
+    input_callback(gpio, level, time_us);
+}
+
+void hal_input_irq(uint pin, void (*callback)(uint pin, bool level, uint64_t time_us)) {
+    input_callback = callback;
+    gpio_set_irq_enabled_with_callback(pin, GPIO_IRQ_EDGE_RISE | GPIO_IRQ_EDGE_FALL, true, hal_gpio_irq);
+}
+
+// Inicializa a PIO para enviar dados aos LEDs do tipo WS2812
+void hal_np_init(uint pin, uint lanes) {
+    np_pio = pio0;
+    np_lanes = lanes;
+
+    // Tenta obter uma state machine livre no pio0; se não houver, usa o pio1
+    int claimed = pio_claim_unused_sm(np_pio, false);
+    if (claimed < 0) {
+        np_pio = pio1;
+        claimed = pio_claim_unused_sm(np_pio, true);
+    }
+    np_sm = (uint)claimed;
+
+    // Adiciona o programa na PIO escolhida e inicia a SM a 800kHz (NeoPixel)
+    if (lanes > 1) {
+        uint offset = pio_add_program(np_pio, &ws2812_paralelo_program);
+        ws2812_paralelo_program_init(np_pio, np_sm, offset, pin, lanes, HAL_NP_FREQ);
+    } else {
+        uint offset = pio_add_program(np_pio, &ws2818b_program);
+        ws2818b_program_init(np_pio, np_sm, offset, pin, HAL_NP_FREQ);
+    }
+
+    // DMA de palavras de 32 bits para a FIFO de TX, no ritmo do DREQ da SM
+    np_dma_channel = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(np_dma_channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(np_pio, np_sm, true));
+    dma_channel_configure(np_dma_channel, &c, &np_pio->txf[np_sm], NULL, 0, false);
+}
+
+void __not_in_flash_func(hal_np_write_async)(const uint32_t *words, size_t count) {
+    hal_np_wait();
+    dma_channel_transfer_from_buffer_now(np_dma_channel, words, np_lanes > 1 ? count * HAL_NP_LANE_WORDS : count);
+
+    // A PIO envia cada LED em 24 bits a 800kHz (30us), em ritmo fixo: o frame
+    // termina em count * 30us, com qualquer número de fitas. A FIFO pode
+    // atrasar o início em alguns bits, então soma-se uma folga de um LED antes
+    // do tempo de reset. O prazo é consultado pelo relógio, sem alarme: não
+    // depende de haver um alarme livre no pool do SDK
+    uint64_t frame_us = (uint64_t)(count + 1) * 24 * 1000000 / HAL_NP_FREQ;
+    np_fim = make_timeout_time_us(frame_us + HAL_NP_RESET_US);
+}
+
+bool __not_in_flash_func(hal_np_busy)(void) {
+    return !time_reached(np_fim);
+}
+
+void __not_in_flash_func(hal_np_wait)(void) {
+    while (hal_np_busy()) {
+        tight_loop_contents();
+    }
+}
+
+void hal_i2c_init(uint port, uint sda, uint scl, uint baudrate) {
+    i2c_init(hal_i2c_inst(port), baudrate);
+    gpio_set_function(sda, GPIO_FUNC_I2C);
+    gpio_set_function(scl, GPIO_FUNC_I2C);
+    gpio_pull_up(sda);
+    gpio_pull_up(scl);
+
+    // Canal DMA da sequência assíncrona: palavras de 16 bits para o IC_DATA_CMD,
+    // no ritmo do DREQ de TX do I2C
+    i2c_inst_t *i2c = hal_i2c_inst(port);
+    hal_i2c_async_t *async = &i2c_async[port];
+    async->dma_channel = dma_claim_unused_channel(true);
+
+    dma_channel_config c = dma_channel_get_default_config(async->dma_channel);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(i2c, true));
+    dma_channel_configure(async->dma_channel, &c, &i2c_get_hw(i2c)->data_cmd, async->words, 0, false);
+
+    i2c_get_hw(i2c)->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
+}
+
+int hal_i2c_write(uint port, uint8_t address, const uint8_t *src, size_t length) {
+    hal_i2c_async_wait(port);
+    return i2c_write_blocking(hal_i2c_inst(port), address, src, length, false);
+}
+
+uint hal_i2c_set_baudrate(uint port, uint baudrate) {
+    hal_i2c_async_wait(port);
+    return i2c_set_baudrate(hal_i2c_inst(port), baudrate);
+}
+
+bool __not_in_flash_func(hal_i2c_async_begin)(uint port, uint8_t address) {
+    if (hal_i2c_async_busy(port)) {
+        return false;
+    }
+    i2c_async[port].count = 0;
+    i2c_async[port].address = address;
+    return true;
+}
+
+bool __not_in_flash_func(hal_i2c_async_append)(uint port, const uint8_t *src, size_t length, bool stop) {
+    hal_i2c_async_t *async = &i2c_async[port];
+    if (async->count + length > HAL_I2C_ASYNC_MAX) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        async->words[async->count++] = src[i];
+    }
+    // O STOP no último byte fecha a transação; o próximo byte gera um novo START
+    if (stop && length) {
+        async->words[async->count - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    }
+    return true;
+}
+
+void __not_in_flash_func(hal_i2c_async_start)(uint port) {
+    hal_i2c_async_t *async = &i2c_async[port];
+    i2c_hw_t *hw = i2c_get_hw(hal_i2c_inst(port));
+    if (!async->count) {
+        return;
+    }
+
+    // Endereço do alvo só pode ser trocado com o controlador desabilitado
+    hw->enable = 0;
+    hw->tar = async->address;
+    hw->enable = 1;
+    (void)hw->clr_tx_abrt;
+
+    dma_channel_transfer_from_buffer_now(async->dma_channel, async->words, async->count);
+}
+
+bool hal_i2c_async_busy(uint port) {
+    i2c_hw_t *hw = i2c_get_hw(hal_i2c_inst(port));
+    return dma_channel_is_busy(i2c_async[port].dma_channel) ||
+           !(hw->status & I2C_IC_STATUS_TFE_BITS) ||
+           (hw->status & I2C_IC_STATUS_ACTIVITY_BITS);
+}
+
+void hal_i2c_async_wait(uint port) {
+    while (hal_i2c_async_busy(port)) {
+        tight_loop_contents();
+    }
+}
+
+const uint8_t *hal_flash_data(void) {
+    return (const uint8_t *)(XIP_BASE + HAL_FLASH_OFFSET);
+}
+
+// Executadas por flash_safe_execute, com o outro núcleo parado e as
+// interrupções desligadas. Ficam na RAM, como as rotinas da flash do SDK, que
+// desligam o XIP durante a operação
+static void __not_in_flash_func(hal_flash_erase_op)(void *param) {
+    const hal_flash_op_t *op = param;
+    flash_range_erase(HAL_FLASH_OFFSET + op->offset, op->length);
+}
+
+static void __not_in_flash_func(hal_flash_program_op)(void *param) {
+    const hal_flash_op_t *op = param;
+    flash_range_program(HAL_FLASH_OFFSET + op->offset, op->src, op->length);
+}
+
+bool hal_flash_erase(uint32_t offset) {
+    if (offset % HAL_FLASH_SECTOR_SIZE || offset >= HAL_FLASH_BYTES) {
+        return false;
+    }
+    hal_flash_op_t op = {offset, NULL, HAL_FLASH_SECTOR_SIZE};
+    return flash_safe_execute(hal_flash_erase_op, &op, HAL_FLASH_LOCKOUT_MS) == PICO_OK;
+}
+
+bool hal_flash_program(uint32_t offset, const uint8_t *src, size_t length) {
+    if (offset % HAL_FLASH_PAGE_SIZE || length % HAL_FLASH_PAGE_SIZE || offset + length > HAL_FLASH_BYTES) {
+        return false;
+    }
+    hal_flash_op_t op = {offset, src, length};
+    return flash_safe_execute(hal_flash_program_op, &op, HAL_FLASH_LOCKOUT_MS) == PICO_OK;
+}
+
+size_t hal_serial_write(const uint8_t *src, size_t length) {
+    if (!stdio_usb_connected()) {
+        return 0;
+    }
+    // Só o que cabe no FIFO do TinyUSB, num bloco só. O driver USB do stdio
+    // pega o seu mutex (o mesmo da tarefa de fundo do TinyUSB) e, como o bloco
+    // cabe, faz um tud_cdc_write e um único tud_cdc_write_flush, sem esperar.
+    // Byte a byte (putchar_raw), cada byte viraria um pacote USB
+    size_t n = MIN(length, (size_t)tud_cdc_write_available());
+    if (n) {
+        stdio_usb.out_chars((const char *)src, (int)n);
+    }
+    return n;
+}
+
+uint64_t __not_in_flash_func(hal_time_us)(void) {
+    return to_us_since_boot(get_absolute_time());
+}
+
+void hal_sleep_us(uint64_t us) {
+    sleep_us(us);
+}
+
+void hal_sleep_ms(uint32_t ms) {
+    sleep_ms(ms);
+}
+
+uint32_t __not_in_flash_func(hal_cycles)(void) {
+    // O SysTick é de cada núcleo: habilita no primeiro uso, com o clock do
+    // processador e recarga máxima
+    if (!(systick_hw->csr & 1)) {
+        systick_hw->rvr = HAL_CYCLES_MASK;
+        systick_hw->cvr = 0;
+        systick_hw->csr = 0x5;
+    }
+    // Conta para baixo; invertido, vira um contador crescente
+    return HAL_CYCLES_MASK - systick_hw->cvr;
+}
+
+uint32_t hal_cycles_per_us(void) {
+    return clock_get_hz(clk_sys) / 1000000;
+}
+
+static bool __not_in_flash_func(hal_timer_fired)(repeating_timer_t *rt) {
+    (void)rt;
+    timer_callback();
+    return true;
+}
+
+void hal_timer_start(uint32_t period_us, void (*callback)(void)) {
+    cancel_repeating_timer(&timer);
+    timer_callback = callback;
+    // Atraso negativo: o período é contado entre os inícios de cada chamada,
+    // então o tempo gasto no callback não acumula deriva
+    add_repeating_timer_us(-(int64_t)period_us, hal_timer_fired, NULL, &timer);
+}
+
+void __not_in_flash_func(hal_wait_event)(void) {
+    __wfe();
+}
+
+void __not_in_flash_func(hal_signal_event)(void) {
+    __sev();
+}
+
+// O core 1 aceita ser parado pelo core 0 (multicore lockout) enquanto a flash
+// é apagada ou programada: o seu código também roda da flash
+static void hal_core1_main(void) {
+    flash_safe_execute_core_init();
+    core1_entry();
+}
+
+bool hal_launch_core1(void (*entry)(void)) {
+    core1_entry = entry;
+    multicore_launch_core1(hal_core1_main);
+    return true;
+}
+
+uint32_t hal_irq_disable(void) {
+    return save_and_disable_interrupts();
+}
+
+void hal_irq_restore(uint32_t state) {
+    restore_interrupts(state);
+}
@@ -0,0 +1,118 @@
+#include "input.h"
+#include "spsc.h"
+
+// Estado de debounce de um botão registrado
+typedef struct {
+    uint pin;
+    uint32_t debounce_us;
+    uint64_t last_us; // Instante do último evento aceito
+    bool pressed;     // Estado após o debounce
+} input_pin_t;
+
+static input_pin_t pins[INPUT_MAX_PINS];
+static uint pin_count;
+
+// Fila de eventos: a interrupção produz, o loop do jogo consome
+static input_event_t events[INPUT_QUEUE_SIZE];
+static spsc_queue_t queue;
+static input_stats_t stats;
+
+static input_pin_t *__not_in_flash_func(input_find)(uint pin) {
+    for (uint i = 0; i < pin_count; i++) {
+        if (pins[i].pin == pin) {
+            return &pins[i];
+        }
+    }
+    return NULL;
+}
+
+// Aceita uma mudança de estado e a publica na fila. Roda na interrupção ou com
+// ela desabilitada, então há um único produtor por vez
+static void __not_in_flash_func(input_push)(input_pin_t *p, bool pressed, uint64_t time_us) {
+    p->pressed = pressed;
+    p->last_us = time_us;
+
+    int slot = spsc_reserve(&queue);
+    if (slot < 0) {
+        stats.dropped++;
+        return;
+    }
+    events[slot] = (input_event_t){.time_us = time_us, .pin = (uint8_t)p->pin, .pressed = pressed};
+    spsc_commit(&queue);
+    stats.events++;
+}
+
+// Callback de borda da HAL (contexto de interrupção no Pico)
+static void __not_in_flash_func(input_edge)(uint pin, bool level, uint64_t time_us) {
+    input_pin_t *p = input_find(pin);
+    bool pressed = !level;
+    if (!p || pressed == p->pressed) {
+        return;
+    }
+    if (time_us - p->last_us < p->debounce_us) {
+        stats.bounces++;
+        return;
+    }
+    input_push(p, pressed, time_us);
+}
+
+// A última borda de uma trepidação pode ter caído dentro da janela e sido
+// ignorada, deixando o estado desatualizado: passada a janela, vale o nível lido
+static void input_resync(void) {
+    uint64_t now = hal_time_us();
+    uint32_t save = hal_irq_disable();
+    for (uint i = 0; i < pin_count; i++) {
+        input_pin_t *p = &pins[i];
+        bool pressed = !hal_input_get(p->pin);
+        if (pressed != p->pressed && now - p->last_us >= p->debounce_us) {
+            stats.resyncs++;
+            input_push(p, pressed, now);
+        }
+    }
+    hal_irq_restore(save);
+}
+
+void input_init(uint pin, uint32_t debounce_us) {
+    if (pin_count == 0) {
+        spsc_init(&queue, INPUT_QUEUE_SIZE);
+    }
+    if (pin_count == INPUT_MAX_PINS || input_find(pin)) {
+        return;
+    }
+
+    hal_input_init(pin);
+
+    // Estado inicial lido do pino, sem evento; a janela começa já vencida
+    input_pin_t *p = &pins[pin_count];
+    p->pin = pin;
+    p->debounce_us = debounce_us;
+    p->last_us = hal_time_us() - debounce_us;
+    p->pressed = !hal_input_get(pin);
+
+    uint32_t save = hal_irq_disable();
+    pin_count++;
+    hal_irq_restore(save);
+
+    hal_input_irq(pin, input_edge);
+}
+
+bool __not_in_flash_func(input_poll)(input_event_t *event) {
+    input_resync();
+
+    int slot = spsc_peek(&queue);
+    if (slot < 0) {
+        return false;
+    }
+    *event = events[slot];
+    spsc_release(&queue);
+    return true;
+}
+
+bool __not_in_flash_func(input_pressed)(uint pin) {
+    input_pin_t *p = input_find(pin);
+    return p && p->pressed;
+}
+
+const input_stats_t *input_stats(void) {
+    return &stats;
+}
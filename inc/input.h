@@ -0,0 +1,49 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal.h"
+
+#ifndef input_inc_h
+#define input_inc_h
+
+//------------------------------------------------------------------------------
+// Botões por interrupção, com eventos datados e debounce
+//------------------------------------------------------------------------------
+// Cada borda de um pino registrado gera uma interrupção que grava um evento
+// (pino, pressionado/solto, instante em us) numa fila sem trava. O jogo consome
+// os eventos a cada tick, então um toque mais curto que o passo lógico não se
+// perde. Bordas que chegam dentro da janela de debounce do pino, contada a
+// partir do último evento aceito, são tratadas como trepidação do contato.
+//------------------------------------------------------------------------------
+
+// Capacidade da fila de eventos
+#define INPUT_QUEUE_SIZE 32
+// Quantidade máxima de botões registrados
+#define INPUT_MAX_PINS 4
+// Janela de debounce sugerida para botões de contato comuns
+#define INPUT_DEBOUNCE_US 5000
+
+typedef struct {
+    uint64_t time_us; // Instante da borda
+    uint8_t pin;
+    bool pressed;
+} input_event_t;
+
+typedef struct {
+    uint32_t events;  // Eventos entregues à fila
+    uint32_t bounces; // Bordas ignoradas pelo debounce
+    uint32_t resyncs; // Mudanças detectadas por leitura após a janela de debounce
+    uint32_t dropped; // Eventos perdidos com a fila cheia
+} input_stats_t;
+
+// Registra um botão com pull-up (pressionado = nível baixo) e seu debounce
+void input_init(uint pin, uint32_t debounce_us);
+
+// Retira o evento mais antigo da fila. Retorna false se não houver eventos
+bool input_poll(input_event_t *event);
+
+// Estado atual do botão, já filtrado pelo debounce
+bool input_pressed(uint pin);
+
+const input_stats_t *input_stats(void);
+
+#endif
@@ -0,0 +1,116 @@
+#include "jogo.h"
+
+// Sprites do dinossauro (em pé e abaixado); no ar, o sprite em pé sobe as
+// linhas da altura arredondada
+#define JOGO_DINO_EM_PE (SPRITE_BIT(3, 0) | SPRITE_BIT(4, 0))
+#define JOGO_DINO_ABAIXADO (SPRITE_BIT(4, 0) | SPRITE_BIT(4, 1))
+
+// Faixas onde os inimigos surgem
+#define JOGO_FAIXA_MIN 2
+#define JOGO_FAIXA_MAX 4
+
+const fisica_curva_t jogo_curva_padrao = {
+    .inicial_us = 200000,
+    .minimo_us = 50000,
+    .reducao_us = 25000,
+    .intervalo_ms = 5000};
+
+// Padrões de inimigos: {peso, intervalo em passos, n, {coluna, faixa, tipo,
+// velocidade %}}. Inimigos de um mesmo padrão nunca dividem a coluna, para que
+// sempre haja uma forma de desviar
+#define FAIXA_ALEATORIA OBSTACULO_FAIXA_ALEATORIA
+#define FAIXA_DO_PADRAO OBSTACULO_FAIXA_DO_PADRAO
+
+// Um inimigo em linha aleatória; o próximo surge depois que ele sai
+static const obstaculo_padrao_t jogo_padroes_classico[] = {
+    {1, 6, 1, {{0, FAIXA_ALEATORIA, OBSTACULO_NORMAL, 100}}},
+};
+
+static const obstaculo_padrao_t jogo_padroes_dificil[] = {
+    {4, 3, 1, {{0, FAIXA_ALEATORIA, OBSTACULO_NORMAL, 100}}},
+    // Dois na mesma linha (sorteada para o par), com duas colunas de folga
+    {2, 5, 2, {{0, FAIXA_DO_PADRAO, OBSTACULO_NORMAL, 100}, {2, FAIXA_DO_PADRAO, OBSTACULO_NORMAL, 100}}},
+    // Escada: chão e depois meio
+    {1, 5, 2, {{0, 4, OBSTACULO_NORMAL, 100}, {2, 3, OBSTACULO_NORMAL, 100}}},
+    // Um inimigo com o dobro da velocidade
+    {2, 4, 1, {{0, FAIXA_ALEATORIA, OBSTACULO_RAPIDO, 200}}},
+};
+
+const obstaculo_padrao_t *jogo_padroes(uint dificuldade, uint *n)
+{
+  if (dificuldade == 0)
+  {
+    *n = count_of(jogo_padroes_classico);
+    return jogo_padroes_classico;
+  }
+  *n = count_of(jogo_padroes_dificil);
+  return jogo_padroes_dificil;
+}
+
+void jogo_init(jogo_t *j, uint dificuldade, const fisica_curva_t *curva, uint32_t semente)
+{
+  uint n_padroes;
+  const obstaculo_padrao_t *padroes = jogo_padroes(dificuldade, &n_padroes);
+
+  fisica_dino_init(&j->dino);
+  obstaculos_init(&j->inimigos, padroes, n_padroes, SPRITE_COLUNAS - 1, JOGO_FAIXA_MIN, JOGO_FAIXA_MAX,
+                  semente);
+  j->curva = *curva;
+  j->tempo_ms = 0;
+  j->periodo_us = curva->inicial_us;
+  j->dino_mask = JOGO_DINO_EM_PE;
+  for (uint tipo = 0; tipo < OBSTACULOS_TIPOS; tipo++)
+  {
+    j->mascaras[tipo] = 0;
+  }
+  j->desviados = 0;
+  j->colidiu = false;
+}
+
+uint __not_in_flash_func(jogo_passo)(jogo_t *j, uint8_t entradas)
+{
+  if (j->colidiu)
+  {
+    return 0;
+  }
+
+  bool pulo = entradas & ENTRADA_PULO;
+  bool abaixar = entradas & ENTRADA_ABAIXAR;
+
+  // Velocidade atual dos inimigos, pela curva no tempo lógico
+  j->tempo_ms += FISICA_PASSO_US / 1000;
+  j->periodo_us = fisica_curva_periodo_us(&j->curva, j->tempo_ms);
+  fx_t deslocamento = fisica_deslocamento(j->periodo_us);
+
+  // Subpassos da física: o dino e os inimigos andam juntos e a colisão é
+  // conferida em cada um, já na grade dos LEDs
+  uint desviados = 0;
+  for (uint sub = 0; sub < FISICA_SUBPASSOS && !j->colidiu; sub++)
+  {
+    fisica_dino_passo(&j->dino, pulo, abaixar);
+
+    // Sprite do dino: abaixado ou em pé, na altura
+    if (j->dino.abaixado)
+    {
+      j->dino_mask = JOGO_DINO_ABAIXADO;
+    }
+    else
+    {
+      j->dino_mask = JOGO_DINO_EM_PE >> (SPRITE_COLUNAS * fisica_dino_linhas(&j->dino));
+    }
+
+    // Gera, move e remove os inimigos em uma passada; os que saíram pela
+    // esquerda foram desviados
+    desviados += obstaculos_passo(&j->inimigos, FISICA_DT_US, j->periodo_us, deslocamento, j->mascaras);
+
+    sprite_mask_t todos_inimigos = 0;
+    for (uint tipo = 0; tipo < OBSTACULOS_TIPOS; tipo++)
+    {
+      todos_inimigos = sprite_compoe(todos_inimigos, j->mascaras[tipo]);
+    }
+    j->colidiu = sprite_colide(j->dino_mask, todos_inimigos);
+  }
+
+  j->desviados += desviados;
+  return desviados;
+}
@@ -0,0 +1,68 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal.h"
+#include "sprite.h"
+#include "fisica.h"
+#include "obstaculos.h"
+
+#ifndef jogo_inc_h
+#define jogo_inc_h
+
+//------------------------------------------------------------------------------
+// Lógica do jogo como transição de estado pura
+//------------------------------------------------------------------------------
+// Todo o estado de uma partida (dino, inimigos, tempo e placar) fica em um
+// jogo_t, e jogo_passo avança um tick lógico a partir só desse estado e das
+// entradas do tick: sem HAL, relógio ou variáveis globais. O mesmo passo roda
+// no jogo (dino_runner.c), no replay e nas simulações do autoplayer
+// (tools/dino_autoplay.c), e o resultado depende apenas da semente, da curva
+// de velocidade e das entradas.
+//------------------------------------------------------------------------------
+
+// Tipos de obstáculo (um por camada de cor)
+enum
+{
+  OBSTACULO_NORMAL,
+  OBSTACULO_RAPIDO,
+};
+
+// Entradas de um tick lógico, como gravadas no log de replay
+#define ENTRADA_PULO 0x01
+#define ENTRADA_ABAIXAR 0x02
+
+// Dificuldades: 0 = um inimigo por vez (jogo original), 1 = padrões com vários
+// inimigos e inimigos rápidos
+#define JOGO_DIFICULDADES 2
+
+typedef struct
+{
+  fisica_dino_t dino;
+  obstaculos_t inimigos;
+  fisica_curva_t curva;
+
+  uint32_t tempo_ms;   // Tempo lógico (ticks * FISICA_PASSO_US)
+  uint32_t periodo_us; // Período atual dos inimigos, pela curva
+
+  // Máscaras após o último subpasso (colisão e desenho)
+  sprite_mask_t dino_mask;
+  sprite_mask_t mascaras[OBSTACULOS_TIPOS];
+
+  uint32_t desviados;
+  bool colidiu;
+} jogo_t;
+
+// Curva de velocidade do jogo: 200 ms por casa no início, 25 ms a menos a
+// cada 5 s de jogo, até 50 ms
+extern const fisica_curva_t jogo_curva_padrao;
+
+// Padrões de inimigos da dificuldade (0 ou 1); em *n, a quantidade
+const obstaculo_padrao_t *jogo_padroes(uint dificuldade, uint *n);
+
+// Começa uma partida; os inimigos são sorteados a partir da semente
+void jogo_init(jogo_t *j, uint dificuldade, const fisica_curva_t *curva, uint32_t semente);
+
+// Avança um tick lógico com as entradas do tick (ENTRADA_*). Depois de uma
+// colisão o estado não muda mais. Retorna quantos inimigos foram desviados
+uint jogo_passo(jogo_t *j, uint8_t entradas);
+
+#endif
@@ -0,0 +1,24 @@
+#include "np_color.h"
+
+// Repetição das entradas: gera os 256 valores de um canal em tempo de compilação
+#define NP_LUT_4(i, l, w) \
+  NP_LUT_ENTRY((i), l, w), NP_LUT_ENTRY((i) + 1, l, w), NP_LUT_ENTRY((i) + 2, l, w), NP_LUT_ENTRY((i) + 3, l, w)
+#define NP_LUT_16(i, l, w) \
+  NP_LUT_4((i), l, w), NP_LUT_4((i) + 4, l, w), NP_LUT_4((i) + 8, l, w), NP_LUT_4((i) + 12, l, w)
+#define NP_LUT_64(i, l, w) \
+  NP_LUT_16((i), l, w), NP_LUT_16((i) + 16, l, w), NP_LUT_16((i) + 32, l, w), NP_LUT_16((i) + 48, l, w)
+#define NP_LUT_256(l, w) \
+  {NP_LUT_64(0, l, w), NP_LUT_64(64, l, w), NP_LUT_64(128, l, w), NP_LUT_64(192, l, w)}
+
+// Um nível de brilho: canais na ordem G, R, B
+#define NP_LUT_LEVEL(l)                 \
+  {NP_LUT_256(l, NP_WHITE_BALANCE_G),   \
+   NP_LUT_256(l, NP_WHITE_BALANCE_R),   \
+   NP_LUT_256(l, NP_WHITE_BALANCE_B)}
+
+const uint16_t np_color_lut[NP_BRIGHTNESS_LEVELS][3][256] = {
+    NP_LUT_LEVEL(NP_BRIGHTNESS_LEVEL_0),
+    NP_LUT_LEVEL(NP_BRIGHTNESS_LEVEL_1),
+    NP_LUT_LEVEL(NP_BRIGHTNESS_LEVEL_2),
+    NP_LUT_LEVEL(NP_BRIGHTNESS_LEVEL_3),
+};
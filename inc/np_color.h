@@ -0,0 +1,69 @@
+#include <stdint.h>
+
+#ifndef np_color_inc_h
+#define np_color_inc_h
+
+//------------------------------------------------------------------------------
+// Tabelas de cor dos LEDs WS2812: gama + brilho + balanço de branco
+//------------------------------------------------------------------------------
+// Cada entrada converte um valor 0..255 de um canal em intensidade de saída no
+// formato 8.8 (parte inteira no byte alto, fração no byte baixo). A fração é
+// usada pelo pontilhamento temporal; sem ele, o valor é arredondado.
+// As tabelas são geradas pelo pré-processador e ficam em flash: nenhum cálculo
+// em ponto flutuante é feito em tempo de execução (o RP2040 não tem FPU).
+//------------------------------------------------------------------------------
+
+// Níveis de brilho selecionáveis, em porcentagem
+#define NP_BRIGHTNESS_LEVELS 4
+#ifndef NP_BRIGHTNESS_LEVEL_0
+#define NP_BRIGHTNESS_LEVEL_0 10
+#endif
+#ifndef NP_BRIGHTNESS_LEVEL_1
+#define NP_BRIGHTNESS_LEVEL_1 30
+#endif
+#ifndef NP_BRIGHTNESS_LEVEL_2
+#define NP_BRIGHTNESS_LEVEL_2 60
+#endif
+#ifndef NP_BRIGHTNESS_LEVEL_3
+#define NP_BRIGHTNESS_LEVEL_3 100
+#endif
+// Nível usado ao ligar (30%, o antigo LED_BRIGHTNESS = 0.3f)
+#ifndef NP_BRIGHTNESS_DEFAULT
+#define NP_BRIGHTNESS_DEFAULT 1
+#endif
+
+// Calibração do balanço de branco: ganho de cada canal (255 = sem correção)
+#ifndef NP_WHITE_BALANCE_R
+#define NP_WHITE_BALANCE_R 255
+#endif
+#ifndef NP_WHITE_BALANCE_G
+#define NP_WHITE_BALANCE_G 255
+#endif
+#ifndef NP_WHITE_BALANCE_B
+#define NP_WHITE_BALANCE_B 255
+#endif
+
+// Pontilhamento temporal: acumula a fração de cada canal entre frames, para
+// que brilhos baixos mantenham gradientes suaves (0 desliga)
+#ifndef NP_TEMPORAL_DITHER
+#define NP_TEMPORAL_DITHER 1
+#endif
+
+// Ordem dos canais nas tabelas (a mesma dos bytes enviados aos WS2812)
+#define NP_CHANNEL_G 0
+#define NP_CHANNEL_R 1
+#define NP_CHANNEL_B 2
+
+// Curva de gama ~2.2 aproximada por 0.8*x^2 + 0.2*x^3, em 16 bits (0..65535)
+#define NP_GAMMA16(i) \
+  ((65535ULL * (4ULL * 255 * (i) * (i) + (unsigned long long)(i) * (i) * (i))) / (5ULL * 255 * 255 * 255))
+
+// Entrada da tabela em 8.8: gama * brilho (%) * ganho do canal (/255).
+// O máximo (0xFF00) ainda cabe em 16 bits somado a um erro de 0xFF
+#define NP_LUT_ENTRY(i, level, wb) \
+  ((uint16_t)(NP_GAMMA16(i) * (level) * (wb) * 256 / (255ULL * 257 * 100)))
+
+// [nível][canal][valor] -> intensidade 8.8
+extern const uint16_t np_color_lut[NP_BRIGHTNESS_LEVELS][3][256];
+
+#endif
@@ -0,0 +1,61 @@
+#include "np_geometry.h"
+
+// Entrada i da tabela: casa i / NP_CELL_LEDS, LED i % NP_CELL_LEDS dentro dela
+#define NP_MAP_CELL(i) ((i) / NP_CELL_LEDS)
+#define NP_MAP_X(i) \
+  (NP_BOARD_X + NP_MAP_CELL(i) % SPRITE_COLUNAS * NP_SCALE + (i) % NP_CELL_LEDS % NP_SCALE)
+#define NP_MAP_Y(i) \
+  (NP_BOARD_Y + NP_MAP_CELL(i) / SPRITE_COLUNAS * NP_SCALE + (i) % NP_CELL_LEDS / NP_SCALE)
+#define NP_MAP_1(i) (uint16_t)NP_INDEX(NP_MAP_X(i), NP_MAP_Y(i)),
+
+// Repetição das entradas: blocos de potências de 2 a partir de i
+#define NP_MAP_2(i) NP_MAP_1(i) NP_MAP_1((i) + 1)
+#define NP_MAP_4(i) NP_MAP_2(i) NP_MAP_2((i) + 2)
+#define NP_MAP_8(i) NP_MAP_4(i) NP_MAP_4((i) + 4)
+#define NP_MAP_16(i) NP_MAP_8(i) NP_MAP_8((i) + 8)
+#define NP_MAP_32(i) NP_MAP_16(i) NP_MAP_16((i) + 16)
+#define NP_MAP_64(i) NP_MAP_32(i) NP_MAP_32((i) + 32)
+#define NP_MAP_128(i) NP_MAP_64(i) NP_MAP_64((i) + 64)
+#define NP_MAP_256(i) NP_MAP_128(i) NP_MAP_128((i) + 128)
+#define NP_MAP_512(i) NP_MAP_256(i) NP_MAP_256((i) + 256)
+#define NP_MAP_1024(i) NP_MAP_512(i) NP_MAP_512((i) + 512)
+
+// Início do bloco do bit 'b' do tamanho: a soma dos bits mais altos
+#define NP_MAP_BASE(b) (NP_BOARD_MAP_SIZE & ~((b) * 2 - 1))
+
+// O tamanho é decomposto em potências de 2, do maior bloco para o menor
+const uint16_t np_board_map[NP_BOARD_MAP_SIZE] = {
+#if NP_BOARD_MAP_SIZE & 1024
+    NP_MAP_1024(NP_MAP_BASE(1024))
+#endif
+#if NP_BOARD_MAP_SIZE & 512
+    NP_MAP_512(NP_MAP_BASE(512))
+#endif
+#if NP_BOARD_MAP_SIZE & 256
+    NP_MAP_256(NP_MAP_BASE(256))
+#endif
+#if NP_BOARD_MAP_SIZE & 128
+    NP_MAP_128(NP_MAP_BASE(128))
+#endif
+#if NP_BOARD_MAP_SIZE & 64
+    NP_MAP_64(NP_MAP_BASE(64))
+#endif
+#if NP_BOARD_MAP_SIZE & 32
+    NP_MAP_32(NP_MAP_BASE(32))
+#endif
+#if NP_BOARD_MAP_SIZE & 16
+    NP_MAP_16(NP_MAP_BASE(16))
+#endif
+#if NP_BOARD_MAP_SIZE & 8
+    NP_MAP_8(NP_MAP_BASE(8))
+#endif
+#if NP_BOARD_MAP_SIZE & 4
+    NP_MAP_4(NP_MAP_BASE(4))
+#endif
+#if NP_BOARD_MAP_SIZE & 2
+    NP_MAP_2(NP_MAP_BASE(2))
+#endif
+#if NP_BOARD_MAP_SIZE & 1
+    NP_MAP_1(NP_MAP_BASE(1))
+#endif
+};
@@ -0,0 +1,114 @@
+#include <stdint.h>
+#include "sprite.h"
+
+#ifndef np_geometry_inc_h
+#define np_geometry_inc_h
+
+//------------------------------------------------------------------------------
+// Geometria da matriz de LEDs WS2812
+//------------------------------------------------------------------------------
+// A matriz é formada por painéis de NP_PANEL_WIDTH x NP_PANEL_HEIGHT LEDs,
+// encadeados em NP_PANELS_X x NP_PANELS_Y. Em cada painel, o LED 0 fica no
+// canto de origem (NP_ORIGIN_RIGHT / NP_ORIGIN_BOTTOM) e a fiação percorre as
+// linhas a partir dele, em zigue-zague (NP_SERPENTINE) ou sempre no mesmo
+// sentido. Os painéis são encadeados da mesma forma: o primeiro fica no canto
+// de origem e as linhas de painéis seguem em zigue-zague se NP_TILE_SERPENTINE.
+//
+// O tabuleiro do jogo (SPRITE_COLUNAS x SPRITE_LINHAS) é ampliado pelo maior
+// fator inteiro que cabe na matriz e centralizado. np_board_map, gerada pelo
+// pré-processador e guardada em flash, já dá o índice físico de cada LED de
+// cada casa: desenhar um frame não faz nenhuma conta por pixel.
+//
+// O padrão é a matriz 5x5 da BitDogLab: LED 0 no canto inferior direito, em
+// zigue-zague.
+//
+// NP_LANES divide a cadeia em fitas do mesmo tamanho, enviadas em paralelo por
+// pinos consecutivos (inc/np_lanes.h): com um painel por fita, a fita k é o
+// painel k do encadeamento. A geometria não muda, só a fiação dos dados.
+//------------------------------------------------------------------------------
+
+#ifndef NP_PANEL_WIDTH
+#define NP_PANEL_WIDTH 5
+#endif
+#ifndef NP_PANEL_HEIGHT
+#define NP_PANEL_HEIGHT 5
+#endif
+#ifndef NP_PANELS_X
+#define NP_PANELS_X 1
+#endif
+#ifndef NP_PANELS_Y
+#define NP_PANELS_Y 1
+#endif
+#ifndef NP_ORIGIN_RIGHT
+#define NP_ORIGIN_RIGHT 1
+#endif
+#ifndef NP_ORIGIN_BOTTOM
+#define NP_ORIGIN_BOTTOM 1
+#endif
+#ifndef NP_SERPENTINE
+#define NP_SERPENTINE 1
+#endif
+#ifndef NP_TILE_SERPENTINE
+#define NP_TILE_SERPENTINE 0
+#endif
+#ifndef NP_LANES
+#define NP_LANES 1
+#endif
+
+#define NP_WIDTH (NP_PANEL_WIDTH * NP_PANELS_X)
+#define NP_HEIGHT (NP_PANEL_HEIGHT * NP_PANELS_Y)
+#define NP_LED_COUNT (NP_WIDTH * NP_HEIGHT)
+
+// Ampliação do tabuleiro (LEDs por lado de cada casa) e seu canto superior
+#define NP_SCALE_X (NP_WIDTH / SPRITE_COLUNAS)
+#define NP_SCALE_Y (NP_HEIGHT / SPRITE_LINHAS)
+#define NP_SCALE (NP_SCALE_X < NP_SCALE_Y ? NP_SCALE_X : NP_SCALE_Y)
+#define NP_BOARD_X ((NP_WIDTH - SPRITE_COLUNAS * NP_SCALE) / 2)
+#define NP_BOARD_Y ((NP_HEIGHT - SPRITE_LINHAS * NP_SCALE) / 2)
+
+// LEDs por casa e tamanho da tabela
+#define NP_CELL_LEDS (NP_SCALE * NP_SCALE)
+#define NP_BOARD_MAP_SIZE (SPRITE_PIXELS * NP_CELL_LEDS)
+
+#if NP_SCALE < 1
+#error "A matriz de LEDs é menor que o tabuleiro do jogo"
+#endif
+#if NP_BOARD_MAP_SIZE > 2047 || NP_LED_COUNT > 2047
+#error "Matriz de LEDs grande demais (máximo de 2047 LEDs)"
+#endif
+#if NP_LANES < 1 || NP_LANES > 8 || NP_LED_COUNT % NP_LANES
+#error "NP_LANES deve ser de 1 a 8 e dividir a quantidade de LEDs"
+#endif
+
+// LEDs de cada fita
+#define NP_LANE_LEDS (NP_LED_COUNT / NP_LANES)
+
+// Posição (coluna, linha) de um canto, vista a partir do canto de origem
+#define NP_FROM_ORIGIN_X(x, n) (NP_ORIGIN_RIGHT ? (n) - 1 - (x) : (x))
+#define NP_FROM_ORIGIN_Y(y, n) (NP_ORIGIN_BOTTOM ? (n) - 1 - (y) : (y))
+
+// Zigue-zague: linhas ímpares (contadas da origem) correm no sentido oposto
+#define NP_ZIGZAG(x, y, n, serpentine) (((serpentine) && ((y) & 1)) ? (n) - 1 - (x) : (x))
+
+// Painel de um pixel (x, y), na ordem do encadeamento
+#define NP_TILE_ROW(y) NP_FROM_ORIGIN_Y((y) / NP_PANEL_HEIGHT, NP_PANELS_Y)
+#define NP_TILE_COLUMN(x, y) \
+  NP_ZIGZAG(NP_FROM_ORIGIN_X((x) / NP_PANEL_WIDTH, NP_PANELS_X), NP_TILE_ROW(y), NP_PANELS_X, NP_TILE_SERPENTINE)
+#define NP_TILE(x, y) (NP_TILE_ROW(y) * NP_PANELS_X + NP_TILE_COLUMN(x, y))
+
+// Posição dentro do painel, na ordem da fiação
+#define NP_LOCAL_ROW(y) NP_FROM_ORIGIN_Y((y) % NP_PANEL_HEIGHT, NP_PANEL_HEIGHT)
+#define NP_LOCAL_COLUMN(x, y) \
+  NP_ZIGZAG(NP_FROM_ORIGIN_X((x) % NP_PANEL_WIDTH, NP_PANEL_WIDTH), NP_LOCAL_ROW(y), NP_PANEL_WIDTH, NP_SERPENTINE)
+
+// Índice físico (posição na cadeia de LEDs) do pixel (x, y); (0, 0) é o canto
+// superior esquerdo. Expressão constante: serve para gerar tabelas
+#define NP_INDEX(x, y)                                          \
+  (NP_TILE(x, y) * (NP_PANEL_WIDTH * NP_PANEL_HEIGHT) +          \
+   NP_LOCAL_ROW(y) * NP_PANEL_WIDTH + NP_LOCAL_COLUMN(x, y))
+
+// [casa * NP_CELL_LEDS + k] -> índice físico do k-ésimo LED da casa
+// (casa = linha * SPRITE_COLUNAS + coluna, como em SPRITE_BIT)
+extern const uint16_t np_board_map[NP_BOARD_MAP_SIZE];
+
+#endif
@@ -0,0 +1,41 @@
+#include "np_lanes.h"
+
+// Transpõe uma matriz de 8x8 bits: o bit c do byte r vai para o bit r do byte c
+static inline uint64_t np_lanes_transpose8(uint64_t x)
+{
+  uint64_t t;
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAull;
+  x ^= t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCull;
+  x ^= t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ull;
+  x ^= t ^ (t << 28);
+  return x;
+}
+
+void __not_in_flash_func(np_lanes_transpose)(const uint32_t *grb, size_t leds, uint lanes, uint32_t *words)
+{
+  for (size_t i = 0; i < leds; i++)
+  {
+    // Componentes G, R e B do LED i de cada fita, um byte por fita (fitas
+    // ausentes ficam em 0)
+    uint64_t componentes[3] = {0, 0, 0};
+    const uint32_t *led = grb + i;
+    for (uint k = 0; k < lanes; k++, led += leds)
+    {
+      componentes[0] |= (uint64_t)(*led >> 24) << (8 * k);
+      componentes[1] |= (uint64_t)(*led >> 16 & 0xFF) << (8 * k);
+      componentes[2] |= (uint64_t)(*led >> 8 & 0xFF) << (8 * k);
+    }
+
+    // Depois da transposição, o byte b tem o bit b de todas as fitas. A PIO
+    // consome os bytes a partir do baixo, e o bit 7 sai primeiro: cada metade
+    // vai com os bytes invertidos
+    for (uint c = 0; c < 3; c++)
+    {
+      uint64_t planos = np_lanes_transpose8(componentes[c]);
+      *words++ = __builtin_bswap32((uint32_t)(planos >> 32));
+      *words++ = __builtin_bswap32((uint32_t)planos);
+    }
+  }
+}
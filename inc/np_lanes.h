@@ -0,0 +1,29 @@
+#include <stddef.h>
+#include <stdint.h>
+#include "hal.h"
+
+#ifndef np_lanes_inc_h
+#define np_lanes_inc_h
+
+//------------------------------------------------------------------------------
+// Saída paralela dos WS2812: transposição para as palavras da PIO
+//------------------------------------------------------------------------------
+// Com NP_LANES > 1, a cadeia de LEDs é dividida em fitas do mesmo tamanho
+// (a fita k tem os LEDs k * n .. (k + 1) * n - 1 da cadeia), uma por pino, e
+// uma única state machine envia o mesmo bit de todas as fitas a cada período.
+// Um frame leva então o tempo de uma fita só, não o da cadeia inteira.
+//
+// A PIO recebe os bits já transpostos (formato em hal.h): para cada LED de
+// cada fita, 24 bytes, um por bit de G, R e B (do mais significativo), com o
+// bit k de cada byte vindo da fita k. Cada componente de 8 fitas é uma matriz
+// de 8x8 bits, transposta com três trocas de blocos num inteiro de 64 bits.
+//------------------------------------------------------------------------------
+
+// Palavras da PIO de um frame com 'leds' LEDs por fita
+#define NP_LANES_WORDS(leds) ((leds) * HAL_NP_LANE_WORDS)
+
+// Converte as palavras GRB de 'lanes' fitas de 'leds' LEDs cada (em sequência,
+// na ordem da cadeia) nas NP_LANES_WORDS(leds) palavras da PIO
+void np_lanes_transpose(const uint32_t *grb, size_t leds, uint lanes, uint32_t *words);
+
+#endif
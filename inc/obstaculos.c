@@ -0,0 +1,129 @@
+#include "obstaculos.h"
+
+void obstaculos_init(obstaculos_t *o, const obstaculo_padrao_t *padroes, uint n_padroes,
+                     int coluna_inicial, uint faixa_min, uint faixa_max, uint32_t semente)
+{
+  o->n = 0;
+  o->padroes = padroes;
+  o->n_padroes = (uint8_t)n_padroes;
+  o->peso_total = 0;
+  for (uint i = 0; i < n_padroes; i++)
+  {
+    o->peso_total += padroes[i].peso;
+  }
+  o->timer_padrao_us = 0;
+  o->coluna_inicial = (int8_t)coluna_inicial;
+  o->faixa_min = (uint8_t)faixa_min;
+  o->faixa_max = (uint8_t)faixa_max;
+  rng_seed(&o->rng, semente);
+  o->gerados = 0;
+  o->descartados = 0;
+}
+
+// Sorteia um padrão com probabilidade proporcional ao peso
+static const obstaculo_padrao_t *obstaculos_sorteia(obstaculos_t *o)
+{
+  uint32_t r = rng_below(&o->rng, o->peso_total);
+  for (uint i = 0; i < o->n_padroes; i++)
+  {
+    if (r < o->padroes[i].peso)
+    {
+      return &o->padroes[i];
+    }
+    r -= o->padroes[i].peso;
+  }
+  return &o->padroes[o->n_padroes - 1];
+}
+
+// Sorteia uma faixa entre faixa_min e faixa_max
+static uint8_t obstaculos_sorteia_faixa(obstaculos_t *o)
+{
+  return (uint8_t)(o->faixa_min + rng_below(&o->rng, o->faixa_max - o->faixa_min + 1));
+}
+
+static void obstaculos_gera(obstaculos_t *o, const obstaculo_padrao_t *padrao)
+{
+  // Faixa comum do padrão, sorteada no primeiro item que a usar
+  int faixa_padrao = -1;
+  for (uint i = 0; i < padrao->n; i++)
+  {
+    const obstaculo_modelo_t *item = &padrao->itens[i];
+    if (o->n == OBSTACULOS_MAX)
+    {
+      o->descartados++;
+      continue;
+    }
+
+    uint k = o->n++;
+    // Começa no fim da coluna: fica nela um período inteiro
+    o->posicao[k] = ((fx_t)(o->coluna_inicial + item->coluna + 1) << FX_FRACAO) - 1;
+    if (item->faixa == OBSTACULO_FAIXA_ALEATORIA)
+    {
+      o->faixa[k] = obstaculos_sorteia_faixa(o);
+    }
+    else if (item->faixa == OBSTACULO_FAIXA_DO_PADRAO)
+    {
+      if (faixa_padrao < 0)
+      {
+        faixa_padrao = obstaculos_sorteia_faixa(o);
+      }
+      o->faixa[k] = (uint8_t)faixa_padrao;
+    }
+    else
+    {
+      o->faixa[k] = item->faixa;
+    }
+    o->velocidade[k] = (uint16_t)((item->velocidade ? item->velocidade : 100) * 256u / 100);
+    o->tipo[k] = item->tipo;
+    o->gerados++;
+  }
+}
+
+uint __not_in_flash_func(obstaculos_passo)(obstaculos_t *o, uint32_t dt_us, uint32_t periodo_us, fx_t deslocamento,
+                      sprite_mask_t mascaras[OBSTACULOS_TIPOS])
+{
+  // Próximo padrão, se chegou a hora
+  if (o->n_padroes)
+  {
+    o->timer_padrao_us -= (int32_t)dt_us;
+    if (o->timer_padrao_us <= 0)
+    {
+      const obstaculo_padrao_t *padrao = obstaculos_sorteia(o);
+      obstaculos_gera(o, padrao);
+      o->timer_padrao_us += (int32_t)(padrao->intervalo * periodo_us);
+    }
+  }
+
+  for (uint t = 0; t < OBSTACULOS_TIPOS; t++)
+  {
+    mascaras[t] = 0;
+  }
+
+  // Uma passada: move, remove quem saiu e monta as máscaras. Removido, a
+  // posição recebe o último obstáculo, que é processado em seguida
+  uint sairam = 0;
+  uint i = 0;
+  while (i < o->n)
+  {
+    o->posicao[i] -= (deslocamento * o->velocidade[i]) >> 8;
+
+    if (o->posicao[i] < 0)
+    {
+      uint ultimo = --o->n;
+      o->posicao[i] = o->posicao[ultimo];
+      o->faixa[i] = o->faixa[ultimo];
+      o->velocidade[i] = o->velocidade[ultimo];
+      o->tipo[i] = o->tipo[ultimo];
+      sairam++;
+      continue;
+    }
+
+    int coluna = obstaculos_coluna(o, i);
+    if (coluna < SPRITE_COLUNAS)
+    {
+      mascaras[o->tipo[i]] |= SPRITE_BIT(o->faixa[i], coluna);
+    }
+    i++;
+  }
+  return sairam;
+}
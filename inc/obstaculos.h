@@ -0,0 +1,94 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal.h"
+#include "sprite.h"
+#include "rng.h"
+#include "fisica.h"
+
+#ifndef obstaculos_inc_h
+#define obstaculos_inc_h
+
+//------------------------------------------------------------------------------
+// Obstáculos: pool de tamanho fixo e gerador de padrões
+//------------------------------------------------------------------------------
+// Os obstáculos ativos ficam num pool pré-alocado, em vetores paralelos
+// (posição, faixa, velocidade e tipo), sempre compactados em [0, n): a remoção
+// troca o obstáculo pelo último. Um passo (subpasso da física) percorre o pool
+// uma única vez, movendo, removendo quem saiu da tela e montando a máscara de
+// cada tipo para a colisão e o desenho.
+//
+// A posição é contínua, em casas (Q16.16): o obstáculo ocupa a coluna da parte
+// inteira e sai da tela quando a posição fica negativa.
+//
+// Novos obstáculos vêm de uma tabela de padrões sorteados por peso com um
+// gerador xorshift (rng.h). Cada padrão cria alguns obstáculos (coluna relativa
+// ao início, faixa fixa ou aleatória, tipo e velocidade) e define quantos
+// passos esperar até o próximo padrão.
+//------------------------------------------------------------------------------
+
+// Capacidade do pool
+#define OBSTACULOS_MAX 32
+// Tipos de obstáculo (cada um vira uma camada com sua cor)
+#define OBSTACULOS_TIPOS 2
+// Obstáculos criados por um padrão
+#define OBSTACULOS_POR_PADRAO 4
+// Faixa sorteada entre faixa_min e faixa_max
+#define OBSTACULO_FAIXA_ALEATORIA 0xFF
+// Faixa sorteada uma vez por padrão, a mesma para todos os itens que a usam
+#define OBSTACULO_FAIXA_DO_PADRAO 0xFE
+
+typedef struct
+{
+  int8_t coluna;      // Em relação à coluna inicial (> 0 = fora da tela)
+  uint8_t faixa;      // Linha da matriz, OBSTACULO_FAIXA_ALEATORIA ou _DO_PADRAO
+  uint8_t tipo;
+  uint8_t velocidade; // Em % da velocidade atual (100 = normal)
+} obstaculo_modelo_t;
+
+typedef struct
+{
+  uint8_t peso;
+  uint8_t intervalo; // Passos (no período atual) até o próximo padrão
+  uint8_t n;
+  obstaculo_modelo_t itens[OBSTACULOS_POR_PADRAO];
+} obstaculo_padrao_t;
+
+typedef struct
+{
+  // Pool: apenas as posições [0, n) estão ativas
+  uint8_t n;
+  fx_t posicao[OBSTACULOS_MAX];        // Casas (a coluna é a parte inteira)
+  uint8_t faixa[OBSTACULOS_MAX];
+  uint16_t velocidade[OBSTACULOS_MAX]; // Q8.8 da velocidade atual (256 = normal)
+  uint8_t tipo[OBSTACULOS_MAX];
+
+  // Gerador de padrões
+  const obstaculo_padrao_t *padroes;
+  uint8_t n_padroes;
+  uint16_t peso_total;
+  int32_t timer_padrao_us;
+  int8_t coluna_inicial;
+  uint8_t faixa_min, faixa_max;
+  rng_t rng;
+
+  uint32_t gerados;
+  uint32_t descartados; // Não couberam no pool
+} obstaculos_t;
+
+// Prepara o pool vazio; o primeiro padrão é gerado no primeiro passo
+void obstaculos_init(obstaculos_t *o, const obstaculo_padrao_t *padroes, uint n_padroes,
+                     int coluna_inicial, uint faixa_min, uint faixa_max, uint32_t semente);
+
+// Avança dt_us: gera padrões (no período atual 'periodo_us'), anda
+// 'deslocamento' casas (vezes a velocidade de cada um) e monta a máscara
+// visível de cada tipo. Retorna quantos saíram pela esquerda (desviados)
+uint obstaculos_passo(obstaculos_t *o, uint32_t dt_us, uint32_t periodo_us, fx_t deslocamento,
+                      sprite_mask_t mascaras[OBSTACULOS_TIPOS]);
+
+// Coluna de um obstáculo
+static inline int obstaculos_coluna(const obstaculos_t *o, uint i)
+{
+  return o->posicao[i] >> FX_FRACAO;
+}
+
+#endif
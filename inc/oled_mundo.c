@@ -0,0 +1,98 @@
+#include <stdio.h>
+
+#include "oled_mundo.h"
+
+#if ssd1306_height < 64
+#error "A visão do mundo no OLED precisa de um display 128x64"
+#endif
+
+// Bitmaps no formato do framebuffer: páginas de 8 linhas, bit 0 em cima
+
+// Dino em pé (16x16), virado para a direita
+static const uint8_t bitmap_dino[] = {
+    0xE0, 0x80, 0x00, 0x00, 0x00, 0x00, 0x80, 0xC0, 0xFF, 0xFF, 0xFD, 0xFF, 0xBF, 0x2F, 0x0F, 0x0F,
+    0x03, 0x07, 0x0F, 0x1E, 0xFE, 0xBF, 0x1F, 0x3F, 0xFF, 0x8F, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00,
+};
+
+// Dino abaixado (24x8)
+static const uint8_t bitmap_dino_abaixado[] = {
+    0x0E, 0x1C, 0x38, 0xF8, 0xF8, 0x38, 0x38, 0xFC, 0xBC, 0x1C, 0x3E, 0xFE,
+    0xBE, 0x3C, 0x3C, 0x1C, 0x1C, 0x1C, 0x1F, 0x1D, 0x0F, 0x0B, 0x07, 0x07,
+};
+
+// Obstáculos (12x8), um por tipo: cacto e ave (rápido)
+#define OLED_MUNDO_OBSTACULO_LARGURA 12
+static const uint8_t bitmap_obstaculos[OBSTACULOS_TIPOS][OLED_MUNDO_OBSTACULO_LARGURA] = {
+    {0x1C, 0x10, 0x38, 0x20, 0xFF, 0xFF, 0x10, 0x18, 0x0E, 0x00, 0x00, 0x00},
+    {0x08, 0x0C, 0x06, 0x27, 0x7E, 0xFC, 0x78, 0x38, 0x10, 0x10, 0x10, 0x00},
+};
+
+// Chão (16x8): linha no topo e pedrinhas. 16 divide 128, então o padrão
+// continua igual quando a GDDRAM gira na rolagem
+#define OLED_MUNDO_CHAO_LARGURA 16
+static const uint8_t bitmap_chao[OLED_MUNDO_CHAO_LARGURA] = {
+    0x01, 0x41, 0x05, 0x01, 0x01, 0x01, 0x11, 0x01, 0x01, 0x01, 0x05, 0x01, 0x51, 0x01, 0x01, 0x01,
+};
+
+// Desenha o dino conforme a forma da máscara: duas casas de largura é o dino
+// abaixado; senão, o dino em pé, 'altura' casas acima do chão
+static void __not_in_flash_func(oled_mundo_desenha_dino)(uint8_t *ssd, sprite_mask_t dino, fx_t altura) {
+    if (!dino) {
+        return;
+    }
+    int linha = __builtin_ctz(dino) / SPRITE_COLUNAS;
+    int coluna_min = SPRITE_COLUNAS, coluna_max = 0;
+    for (sprite_mask_t m = dino; m; m &= m - 1) {
+        int coluna = __builtin_ctz(m) % SPRITE_COLUNAS;
+        coluna_min = MIN(coluna_min, coluna);
+        coluna_max = MAX(coluna_max, coluna);
+    }
+
+    int x = OLED_MUNDO_X0 + coluna_min * OLED_MUNDO_CELULA;
+    if (coluna_max > coluna_min) {
+        ssd1306_blit(ssd, x, OLED_MUNDO_Y0 + linha * 8, bitmap_dino_abaixado, 24, 8, ssd1306_rop_or);
+    } else {
+        int y = OLED_MUNDO_Y0 + (SPRITE_LINHAS - 2) * 8 - ((altura * 8) >> FX_FRACAO);
+        ssd1306_blit(ssd, x + (OLED_MUNDO_CELULA - 16) / 2, y, bitmap_dino, 16, 16, ssd1306_rop_or);
+    }
+}
+
+void __not_in_flash_func(oled_mundo_desenha)(uint8_t *ssd, sprite_mask_t dino, fx_t altura, const obstaculos_t *o, int desviados) {
+    char placar[24];
+    snprintf(placar, sizeof(placar), "Desviados %d", desviados);
+    ssd1306_draw_string(ssd, 0, 0, placar);
+
+    for (int x = 0; x < ssd1306_width; x += OLED_MUNDO_CHAO_LARGURA) {
+        ssd1306_blit(ssd, x, OLED_MUNDO_PAGINA_CHAO * 8, bitmap_chao, OLED_MUNDO_CHAO_LARGURA, 8, ssd1306_rop_copy);
+    }
+
+    oled_mundo_desenha_dino(ssd, dino, altura);
+
+    // Cada obstáculo fica centrado na sua casa no meio do tempo em que a ocupa:
+    // a posição vai de coluna + 1 a coluna enquanto ele anda meia casa antes e
+    // meia depois
+    for (uint i = 0; i < o->n; i++) {
+        int x = OLED_MUNDO_X0 + ((o->posicao[i] * OLED_MUNDO_CELULA) >> FX_FRACAO) - OLED_MUNDO_CELULA / 2 +
+                (OLED_MUNDO_CELULA - OLED_MUNDO_OBSTACULO_LARGURA) / 2;
+        if (x >= ssd1306_width) {
+            continue;
+        }
+        ssd1306_blit(ssd, x, OLED_MUNDO_Y0 + o->faixa[i] * 8, bitmap_obstaculos[o->tipo[i]],
+                     OLED_MUNDO_OBSTACULO_LARGURA, 8, ssd1306_rop_or);
+    }
+}
+
+ssd1306_scroll_interval_t oled_mundo_rolagem(int periodo_ms) {
+    // O controlador anda no máximo uma coluna a cada 2 quadros (~50 px/s), bem
+    // menos que os inimigos: o chão funciona como fundo em paralaxe
+    if (periodo_ms > 175) {
+        return ssd1306_scroll_5_frames;
+    }
+    if (periodo_ms > 125) {
+        return ssd1306_scroll_4_frames;
+    }
+    if (periodo_ms > 75) {
+        return ssd1306_scroll_3_frames;
+    }
+    return ssd1306_scroll_2_frames;
+}
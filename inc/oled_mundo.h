@@ -0,0 +1,42 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal.h"
+#include "ssd1306.h"
+#include "sprite.h"
+#include "obstaculos.h"
+
+#ifndef oled_mundo_inc_h
+#define oled_mundo_inc_h
+
+//------------------------------------------------------------------------------
+// Visão do jogo em resolução cheia no OLED (128x64)
+//------------------------------------------------------------------------------
+// O tabuleiro 5x5 vira uma cena de pixels: cada casa ocupa OLED_MUNDO_CELULA
+// colunas por uma página (8 linhas), abaixo de uma faixa com o placar. O dino
+// e os obstáculos são bitmaps desenhados com ssd1306_blit, nas posições
+// contínuas da física (inc/fisica.h): os obstáculos andam e o dino pula
+// suavemente, sem o arredondamento para a grade dos LEDs.
+//
+// O chão fica sozinho na última página e é periódico em 128 colunas: ele é
+// enviado uma vez e depois rolado pelo próprio SSD1306 (ssd1306_scroll_pages),
+// sem tráfego no I2C. Assim cada frame só transmite as janelas do dino, dos
+// obstáculos e do placar que mudaram.
+//------------------------------------------------------------------------------
+
+// Largura de uma casa do tabuleiro e coluna onde começa a primeira
+#define OLED_MUNDO_CELULA 24
+#define OLED_MUNDO_X0 4
+// Linha do topo do tabuleiro (abaixo do placar)
+#define OLED_MUNDO_Y0 16
+// Página do chão, rolada pelo controlador
+#define OLED_MUNDO_PAGINA_CHAO (ssd1306_n_pages - 1)
+
+// Desenha a cena inteira em 'ssd' (que deve estar apagado): placar, chão, dino
+// (forma e coluna pela máscara da sua camada, altura pela física) e obstáculos
+void oled_mundo_desenha(uint8_t *ssd, sprite_mask_t dino, fx_t altura, const obstaculos_t *o, int desviados);
+
+// Intervalo de rolagem do chão para o período atual dos inimigos (ms por
+// casa): mais rápido conforme o jogo acelera
+ssd1306_scroll_interval_t oled_mundo_rolagem(int periodo_ms);
+
+#endif
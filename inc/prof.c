@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include "prof.h"
+
+static prof_hist_t hists[PROF_STAGES];
+
+static const char *const stage_names[PROF_STAGES] = {
+    [PROF_FRAME] = "frame",
+    [PROF_INPUT] = "input",
+    [PROF_LOGIC] = "logic",
+    [PROF_PUBLISH] = "publish",
+    [PROF_COMPOSE] = "compose",
+    [PROF_NP_WRITE] = "np_write",
+    [PROF_OLED_TEXT] = "oled_text",
+    [PROF_PAINEL_TEXT] = "painel_text",
+    [PROF_OLED_FLUSH] = "oled_flush",
+};
+
+// Menor valor que cai no balde
+static uint64_t prof_bucket_floor(uint bucket) {
+    if (bucket < 4) {
+        return bucket;
+    }
+    uint octave = bucket / 4 + 1;
+    return (uint64_t)(4 + bucket % 4) << (octave - 2);
+}
+
+#if PROF_ENABLED
+// Balde de um valor: 0..3 exatos; acima, a oitava (posição do bit mais alto)
+// dividida em 4 pelos dois bits seguintes
+static uint __not_in_flash_func(prof_bucket)(uint32_t cycles) {
+    if (cycles < 4) {
+        return cycles;
+    }
+    uint octave = 31 - __builtin_clz(cycles);
+    return (octave - 1) * 4 + ((cycles >> (octave - 2)) & 3);
+}
+
+void __not_in_flash_func(prof_end)(prof_stage_t stage, uint32_t start) {
+    uint32_t cycles = (hal_cycles() - start) & HAL_CYCLES_MASK;
+    prof_hist_t *hist = &hists[stage];
+
+    if (hist->count == 0 || cycles < hist->min) {
+        hist->min = cycles;
+    }
+    if (cycles > hist->max) {
+        hist->max = cycles;
+    }
+    if (hist->budget && cycles > hist->budget) {
+        hist->overruns++;
+    }
+    hist->sum += cycles;
+    hist->count++;
+    hist->buckets[prof_bucket(cycles)]++;
+}
+#endif
+
+void prof_set_budget(prof_stage_t stage, uint32_t budget_us) {
+    hists[stage].budget = budget_us * hal_cycles_per_us();
+}
+
+uint32_t prof_percentile(const prof_hist_t *hist, uint32_t percent) {
+    if (hist->count == 0) {
+        return 0;
+    }
+
+    // Posição da amostra do percentil, arredondada para cima
+    uint64_t rank = ((uint64_t)hist->count * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (uint b = 0; b < PROF_BUCKETS; b++) {
+        seen += hist->buckets[b];
+        if (seen >= rank) {
+            // Limite superior do balde, sem passar do máximo observado
+            uint64_t top = prof_bucket_floor(b + 1) - 1;
+            return top < hist->max ? (uint32_t)top : hist->max;
+        }
+    }
+    return hist->max;
+}
+
+void prof_dump(void) {
+    uint32_t per_us = hal_cycles_per_us();
+
+    // Valores em us com duas casas, sem ponto flutuante
+    #define PROF_US(c) (unsigned long)((uint64_t)(c) * 100 / per_us / 100), \
+                       (unsigned)((uint64_t)(c) * 100 / per_us % 100)
+
+    for (uint s = 0; s < PROF_STAGES; s++) {
+        const prof_hist_t *hist = &hists[s];
+        if (hist->count == 0) {
+            continue;
+        }
+        uint32_t avg = (uint32_t)(hist->sum / hist->count);
+        printf("prof %-11s n=%lu min=%lu.%02u avg=%lu.%02u p99=%lu.%02u max=%lu.%02u over=%lu\n",
+               stage_names[s], (unsigned long)hist->count, PROF_US(hist->min), PROF_US(avg),
+               PROF_US(prof_percentile(hist, 99)), PROF_US(hist->max),
+               (unsigned long)hist->overruns);
+    }
+
+    #undef PROF_US
+}
+
+const prof_hist_t *prof_hist(prof_stage_t stage) {
+    return &hists[stage];
+}
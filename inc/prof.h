@@ -0,0 +1,83 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal.h"
+
+#ifndef prof_inc_h
+#define prof_inc_h
+
+//------------------------------------------------------------------------------
+// Perfilador por etapa do frame
+//------------------------------------------------------------------------------
+// Cada etapa é medida com um par prof_begin/prof_end em volta do trecho (ciclos
+// de hal_cycles). As amostras vão para um histograma de baldes fixos, em escala
+// log-linear (4 baldes por oitava, erro de até 25%), com mínimo, máximo, soma e
+// contagem de estouros do orçamento da etapa. prof_dump imprime um resumo
+// compacto (uma linha por etapa) no stdio, que no Pico é a USB CDC.
+//
+// Cada etapa deve ser medida sempre pelo mesmo núcleo. A leitura no dump não é
+// sincronizada com o outro núcleo: uma linha pode misturar uma amostra nova com
+// contadores antigos, o que é aceitável para estatística.
+//
+// Compilar com PROF_ENABLED=0 remove as medições.
+//------------------------------------------------------------------------------
+
+#ifndef PROF_ENABLED
+#define PROF_ENABLED 1
+#endif
+
+// Etapas medidas
+typedef enum {
+    PROF_FRAME,       // Trabalho do core 0 em um tick (lógica + publicação)
+    PROF_INPUT,       // Consumo dos eventos dos botões
+    PROF_LOGIC,       // Uma atualização lógica (dino, inimigo, colisão)
+    PROF_PUBLISH,     // Montagem e publicação do frame (inclui o texto do OLED)
+    PROF_COMPOSE,     // Composição dos sprites no buffer de LEDs
+    PROF_NP_WRITE,    // Espera, empacotamento e início do envio dos LEDs
+    PROF_OLED_TEXT,   // Texto do placar (core 0, ao montar o frame)
+    PROF_PAINEL_TEXT, // Texto do painel de estatísticas (core 1)
+    PROF_OLED_FLUSH,  // ssd1306_flush_async (diferença + montagem do DMA)
+    PROF_STAGES
+} prof_stage_t;
+
+// 4 baldes por oitava cobrem os 32 bits do contador
+#define PROF_BUCKETS 128
+
+typedef struct {
+    uint32_t count;
+    uint32_t min, max;  // Em ciclos
+    uint64_t sum;
+    uint32_t budget;    // Orçamento em ciclos (0 = sem orçamento)
+    uint32_t overruns;  // Amostras acima do orçamento
+    uint32_t buckets[PROF_BUCKETS];
+} prof_hist_t;
+
+#if PROF_ENABLED
+static inline uint32_t prof_begin(void) {
+    return hal_cycles();
+}
+
+// Registra o tempo decorrido desde 'start' na etapa
+void prof_end(prof_stage_t stage, uint32_t start);
+#else
+static inline uint32_t prof_begin(void) {
+    return 0;
+}
+
+static inline void prof_end(prof_stage_t stage, uint32_t start) {
+    (void)stage;
+    (void)start;
+}
+#endif
+
+// Define o orçamento de uma etapa em microssegundos (0 = sem orçamento)
+void prof_set_budget(prof_stage_t stage, uint32_t budget_us);
+
+// Percentil (0..100) estimado pelo histograma, em ciclos (limite do balde)
+uint32_t prof_percentile(const prof_hist_t *hist, uint32_t percent);
+
+// Imprime uma linha por etapa com amostras: n, min, avg, p99, max (us) e estouros
+void prof_dump(void);
+
+const prof_hist_t *prof_hist(prof_stage_t stage);
+
+#endif
@@ -0,0 +1,251 @@
+#include <string.h>
+#include "recordes.h"
+
+#define RECORDES_POR_SETOR (HAL_FLASH_SECTOR_SIZE / RECORDES_REGISTRO_BYTES)
+// Bytes cobertos pelo CRC (tudo antes dele)
+#define RECORDES_CRC_BYTES (RECORDES_REGISTRO_BYTES - 4)
+// Registros seguidos que não conferem antes de desistir até o próximo boot
+#define RECORDES_TENTATIVAS 3
+
+static const uint8_t recordes_magic[4] = {'D', 'R', 'S', '1'};
+
+static recordes_t atuais;
+static recordes_stats_t stats;
+
+// Sequência do registro mais novo na flash
+static uint32_t sequencia;
+// Posição (na flash de dados) do próximo registro: sempre em branco ou no
+// início de um setor
+static uint32_t escrita;
+// Setores inteiramente em branco (bit por setor)
+static uint32_t apagados;
+static bool pendente;
+static uint falhas_seguidas;
+
+// Página montada para a programação (fora da flash, que para durante a escrita)
+static uint8_t pagina[HAL_FLASH_PAGE_SIZE];
+
+_Static_assert(HAL_FLASH_SECTORS >= 2 && HAL_FLASH_SECTORS <= 32, "recordes: 2 a 32 setores");
+_Static_assert(HAL_FLASH_PAGE_SIZE % RECORDES_REGISTRO_BYTES == 0, "recordes: registro dentro de uma página");
+
+// CRC-32 (polinômio refletido 0xEDB88320), bit a bit: só roda no boot e ao gravar
+static uint32_t recordes_crc32(const uint8_t *bytes, size_t length) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= bytes[i];
+        for (uint b = 0; b < 8; b++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static void recordes_put_u32(uint8_t *bytes, uint32_t value) {
+    bytes[0] = value;
+    bytes[1] = value >> 8;
+    bytes[2] = value >> 16;
+    bytes[3] = value >> 24;
+}
+
+static uint32_t recordes_get_u32(const uint8_t *bytes) {
+    return bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+static void recordes_codifica(uint8_t *registro, uint32_t seq, const recordes_t *r) {
+    memset(registro, 0, RECORDES_REGISTRO_BYTES);
+    memcpy(registro, recordes_magic, sizeof(recordes_magic));
+    recordes_put_u32(registro + 4, seq);
+    recordes_put_u32(registro + 8, (uint32_t)r->tempo_total_ms);
+    recordes_put_u32(registro + 12, (uint32_t)(r->tempo_total_ms >> 32));
+    recordes_put_u32(registro + 16, r->partidas);
+    recordes_put_u32(registro + 20, r->desviados_total);
+    recordes_put_u32(registro + 24, r->pulos_total);
+    for (uint i = 0; i < RECORDES_MELHORES; i++) {
+        recordes_put_u32(registro + 28 + 4 * i, r->melhores[i]);
+    }
+    recordes_put_u32(registro + 48, r->ultimo);
+    recordes_put_u32(registro + RECORDES_CRC_BYTES, recordes_crc32(registro, RECORDES_CRC_BYTES));
+}
+
+// Confere cabeçalho e CRC; se válido, decodifica sequência e recordes
+static bool recordes_decodifica(const uint8_t *registro, uint32_t *seq, recordes_t *r) {
+    if (memcmp(registro, recordes_magic, sizeof(recordes_magic)) ||
+        recordes_get_u32(registro + RECORDES_CRC_BYTES) != recordes_crc32(registro, RECORDES_CRC_BYTES)) {
+        return false;
+    }
+    *seq = recordes_get_u32(registro + 4);
+    r->tempo_total_ms = recordes_get_u32(registro + 8) | (uint64_t)recordes_get_u32(registro + 12) << 32;
+    r->partidas = recordes_get_u32(registro + 16);
+    r->desviados_total = recordes_get_u32(registro + 20);
+    r->pulos_total = recordes_get_u32(registro + 24);
+    for (uint i = 0; i < RECORDES_MELHORES; i++) {
+        r->melhores[i] = recordes_get_u32(registro + 28 + 4 * i);
+    }
+    r->ultimo = recordes_get_u32(registro + 48);
+    return true;
+}
+
+static bool recordes_em_branco(const uint8_t *bytes, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (bytes[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint32_t recordes_proximo(uint32_t posicao) {
+    return (posicao + RECORDES_REGISTRO_BYTES) % HAL_FLASH_BYTES;
+}
+
+// Setor que a escrita ocupa a seguir: o da posição atual, se ela está no
+// início de um setor, ou o próximo. Nunca é o do registro mais novo
+static uint recordes_setor_seguinte(void) {
+    uint setor = escrita / HAL_FLASH_SECTOR_SIZE;
+    return escrita % HAL_FLASH_SECTOR_SIZE ? (setor + 1) % HAL_FLASH_SECTORS : setor;
+}
+
+void recordes_init(void) {
+    const uint8_t *flash = hal_flash_data();
+    bool achou = false;
+    uint32_t mais_novo = 0;
+
+    memset(&atuais, 0, sizeof(atuais));
+    memset(&stats, 0, sizeof(stats));
+    sequencia = 0;
+    apagados = 0;
+    pendente = false;
+    falhas_seguidas = 0;
+
+    // Varredura única: registros válidos, o mais novo e os setores em branco
+    for (uint setor = 0; setor < HAL_FLASH_SECTORS; setor++) {
+        bool em_branco = true;
+        for (uint i = 0; i < RECORDES_POR_SETOR; i++) {
+            uint32_t posicao = setor * HAL_FLASH_SECTOR_SIZE + i * RECORDES_REGISTRO_BYTES;
+            const uint8_t *registro = flash + posicao;
+            if (recordes_em_branco(registro, RECORDES_REGISTRO_BYTES)) {
+                continue;
+            }
+            em_branco = false;
+
+            uint32_t seq;
+            recordes_t r;
+            if (!recordes_decodifica(registro, &seq, &r)) {
+                stats.corrompidos++;
+                continue;
+            }
+            stats.validos++;
+            // Comparação com sinal: a sequência pode dar a volta
+            if (!achou || (int32_t)(seq - sequencia) > 0) {
+                achou = true;
+                sequencia = seq;
+                mais_novo = posicao;
+                atuais = r;
+            }
+        }
+        if (em_branco) {
+            apagados |= 1u << setor;
+        }
+    }
+
+    // A escrita continua depois do mais novo, pulando restos de uma gravação
+    // interrompida; no fim do setor, o próximo será apagado antes do uso
+    escrita = 0;
+    if (achou) {
+        escrita = recordes_proximo(mais_novo);
+        while (escrita % HAL_FLASH_SECTOR_SIZE &&
+               !recordes_em_branco(flash + escrita, RECORDES_REGISTRO_BYTES)) {
+            escrita = recordes_proximo(escrita);
+        }
+    }
+}
+
+const recordes_t *recordes_atuais(void) {
+    return &atuais;
+}
+
+int recordes_registra(uint32_t desviados, uint32_t pulos, uint32_t tempo_ms) {
+    atuais.partidas++;
+    atuais.desviados_total += desviados;
+    atuais.pulos_total += pulos;
+    atuais.tempo_total_ms += tempo_ms;
+    atuais.ultimo = desviados;
+
+    // Insere o placar na lista ordenada (empates ficam atrás dos mais antigos)
+    int posicao = -1;
+    for (uint i = 0; i < RECORDES_MELHORES; i++) {
+        if (desviados > atuais.melhores[i]) {
+            memmove(&atuais.melhores[i + 1], &atuais.melhores[i],
+                    (RECORDES_MELHORES - 1 - i) * sizeof(atuais.melhores[0]));
+            atuais.melhores[i] = desviados;
+            posicao = (int)i;
+            break;
+        }
+    }
+
+    pendente = true;
+    falhas_seguidas = 0;
+    return posicao;
+}
+
+// Programa o registro na posição de escrita: a página vai toda em 0xFF, menos
+// o registro, então os vizinhos já gravados não mudam
+static bool recordes_grava(void) {
+    uint32_t inicio = escrita - escrita % HAL_FLASH_PAGE_SIZE;
+    memset(pagina, 0xFF, sizeof(pagina));
+    recordes_codifica(pagina + escrita % HAL_FLASH_PAGE_SIZE, sequencia + 1, &atuais);
+
+    if (!hal_flash_program(inicio, pagina, sizeof(pagina))) {
+        stats.falhas++;
+        return false;
+    }
+    apagados &= ~(1u << (escrita / HAL_FLASH_SECTOR_SIZE));
+
+    // Confere a leitura; um registro que não bate fica como lixo (CRC) e a
+    // gravação é refeita na posição seguinte
+    uint32_t posicao = escrita;
+    escrita = recordes_proximo(escrita);
+    if (memcmp(hal_flash_data() + posicao, pagina + posicao % HAL_FLASH_PAGE_SIZE, RECORDES_REGISTRO_BYTES)) {
+        stats.falhas++;
+        if (++falhas_seguidas >= RECORDES_TENTATIVAS) {
+            pendente = false;
+        }
+        return true;
+    }
+
+    sequencia++;
+    stats.programacoes++;
+    pendente = false;
+    return true;
+}
+
+bool recordes_trabalha(void) {
+    uint seguinte = recordes_setor_seguinte();
+    bool seguinte_apagado = apagados & (1u << seguinte);
+
+    // O registro primeiro, se a posição já está pronta: fim de setor exige o
+    // próximo apagado
+    if (pendente && (escrita % HAL_FLASH_SECTOR_SIZE || seguinte_apagado)) {
+        return recordes_grava();
+    }
+
+    // Apaga o setor seguinte antes de precisar dele
+    if (!seguinte_apagado) {
+        if (!hal_flash_erase(seguinte * HAL_FLASH_SECTOR_SIZE)) {
+            stats.falhas++;
+            return false;
+        }
+        apagados |= 1u << seguinte;
+        stats.apagamentos++;
+        return true;
+    }
+    return false;
+}
+
+bool recordes_pendente(void) {
+    return pendente;
+}
+
+const recordes_stats_t *recordes_stats(void) {
+    return &stats;
+}
@@ -0,0 +1,74 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal.h"
+
+#ifndef recordes_inc_h
+#define recordes_inc_h
+
+//------------------------------------------------------------------------------
+// Recordes e estatísticas das partidas, guardados na flash de dados
+//------------------------------------------------------------------------------
+// Log de registros de RECORDES_REGISTRO_BYTES na flash de dados da HAL. Cada
+// registro é um retrato completo dos recordes, com número de sequência e
+// CRC-32: gravar é acrescentar um registro depois do último, e o mais novo
+// válido é o atual. Um registro cortado no meio (queda de energia) falha o CRC
+// e é ignorado, valendo o anterior.
+//
+// Os setores são usados em rodízio: quando a escrita chega a um setor, ele é
+// apagado (e os retratos antigos dele se perdem), então todos os setores se
+// desgastam por igual. O setor seguinte é apagado assim que a escrita começa
+// no atual, para que gravar um registro custe só a programação de uma página.
+//
+// recordes_registra só altera a cópia em RAM e pode ser chamada em qualquer
+// lugar. A flash é escrita em recordes_trabalha, uma operação por chamada, no
+// Game Over ou com o jogo parado: cada operação para o XIP (e o outro núcleo)
+// por até dezenas de ms.
+//
+// Na inicialização, uma única varredura da região encontra o registro mais
+// novo, a posição de escrita e os setores já apagados.
+//
+// Formato do registro (inteiros little-endian, 64 bytes):
+//   "DRS1", sequência (u32), recordes_t (44 bytes), 8 bytes reservados (0) e
+//   CRC-32 dos 60 bytes anteriores
+//------------------------------------------------------------------------------
+
+#define RECORDES_REGISTRO_BYTES 64
+// Tamanho da lista de melhores placares
+#define RECORDES_MELHORES 5
+
+typedef struct {
+    uint64_t tempo_total_ms;              // Tempo somado de todas as partidas
+    uint32_t partidas;
+    uint32_t desviados_total;
+    uint32_t pulos_total;
+    uint32_t melhores[RECORDES_MELHORES]; // Placares, do maior para o menor
+    uint32_t ultimo;                      // Placar da última partida
+} recordes_t;
+
+typedef struct {
+    uint32_t validos;      // Registros íntegros encontrados na varredura
+    uint32_t corrompidos;  // Registros com CRC ou cabeçalho inválido
+    uint32_t apagamentos;  // Setores apagados desde o boot
+    uint32_t programacoes; // Registros programados desde o boot
+    uint32_t falhas;       // Operações recusadas ou registros que não conferiram
+} recordes_stats_t;
+
+// Varre a flash e carrega os recordes (zerados se não houver registro válido)
+void recordes_init(void);
+
+const recordes_t *recordes_atuais(void);
+
+// Fim de uma partida: atualiza a cópia em RAM, sem acessar a flash. Retorna a
+// posição do placar entre os melhores (0 = recorde) ou -1
+int recordes_registra(uint32_t desviados, uint32_t pulos, uint32_t tempo_ms);
+
+// Faz a próxima operação pendente na flash (gravar o registro ou apagar o
+// setor seguinte). Retorna false quando não há mais nada a fazer agora
+bool recordes_trabalha(void);
+
+// Há um registro esperando para ser gravado
+bool recordes_pendente(void);
+
+const recordes_stats_t *recordes_stats(void);
+
+#endif
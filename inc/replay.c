@@ -0,0 +1,287 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "replay.h"
+
+#define REPLAY_CHECKPOINT 0x80
+#define REPLAY_END 0x81
+#define REPLAY_TRUNCATED 0x82
+#define REPLAY_HEADER_BYTES 8
+// Espaço reservado para a última checagem e o fim do log
+#define REPLAY_RESERVED 6
+
+static const uint8_t replay_magic[4] = {'D', 'R', 'R', '1'};
+
+// Log gravado
+static uint8_t record_log[REPLAY_LOG_MAX];
+static size_t record_length;
+
+// Log reproduzido
+static const uint8_t *play_log;
+static size_t play_length, play_pos;
+static bool playing;
+
+// Sequência atual: sendo acumulada (gravação) ou consumida (reprodução)
+static uint8_t run_inputs;
+static uint32_t run_length;
+// Gravação: ticks das sequências que couberam no log
+static uint32_t record_ticks;
+
+static replay_stats_t stats;
+
+uint32_t replay_hash(const uint32_t *words, size_t count) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < count; i++) {
+        for (uint b = 0; b < 32; b += 8) {
+            hash ^= (words[i] >> b) & 0xFF;
+            hash *= 16777619u;
+        }
+    }
+    return hash;
+}
+
+static void replay_reset(void) {
+    memset(&stats, 0, sizeof(stats));
+    stats.first_mismatch = -1;
+    run_inputs = 0;
+    run_length = 0;
+    record_ticks = 0;
+}
+
+// Acrescenta bytes ao log gravado; fora do fim, respeita a reserva final
+static bool replay_put(const uint8_t *bytes, size_t length, bool final) {
+    size_t limit = final ? REPLAY_LOG_MAX : REPLAY_LOG_MAX - REPLAY_RESERVED;
+    if ((stats.truncated && !final) || record_length + length > limit) {
+        if (!stats.truncated) {
+            stats.truncated = true;
+            stats.truncated_tick = record_ticks;
+        }
+        return false;
+    }
+    memcpy(record_log + record_length, bytes, length);
+    record_length += length;
+    return true;
+}
+
+static void replay_put_u32(uint8_t tag, uint32_t value, bool final) {
+    uint8_t bytes[5] = {tag, value, value >> 8, value >> 16, value >> 24};
+    replay_put(bytes, sizeof(bytes), final);
+}
+
+// Grava a sequência acumulada e começa uma vazia
+static void replay_flush_run(void) {
+    if (!run_length) {
+        return;
+    }
+
+    uint8_t bytes[6];
+    size_t length = 0;
+    uint32_t extra = run_length - 1;
+    bytes[length++] = (uint8_t)(run_inputs << 4 | (extra < 15 ? extra : 15));
+    if (extra >= 15) {
+        // Varint: 7 bits por byte, bit 7 indica que há mais bytes
+        extra -= 15;
+        do {
+            bytes[length++] = (uint8_t)((extra & 0x7F) | (extra > 0x7F ? 0x80 : 0));
+            extra >>= 7;
+        } while (extra);
+    }
+    if (replay_put(bytes, length, false)) {
+        record_ticks += run_length;
+    }
+    run_length = 0;
+}
+
+void replay_record_start(uint32_t seed) {
+    replay_reset();
+    playing = false;
+    record_length = 0;
+    replay_put(replay_magic, sizeof(replay_magic), false);
+    uint8_t bytes[4] = {seed, seed >> 8, seed >> 16, seed >> 24};
+    replay_put(bytes, sizeof(bytes), false);
+}
+
+static uint32_t replay_read_u32(const uint8_t *bytes) {
+    return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+bool replay_play_start(const uint8_t *log, size_t length, uint32_t *seed) {
+    if (length < REPLAY_HEADER_BYTES || memcmp(log, replay_magic, sizeof(replay_magic)) != 0) {
+        return false;
+    }
+    replay_reset();
+    playing = true;
+    play_log = log;
+    play_length = length;
+    play_pos = REPLAY_HEADER_BYTES;
+    *seed = replay_read_u32(log + sizeof(replay_magic));
+    return true;
+}
+
+bool replay_playing(void) {
+    return playing;
+}
+
+static void replay_mismatch(void) {
+    if (stats.mismatches++ == 0) {
+        stats.first_mismatch = (int32_t)stats.ticks;
+    }
+}
+
+// Reprodução: carrega a próxima sequência, pulando checagens não conferidas
+static bool replay_next_run(void) {
+    while (play_pos < play_length) {
+        uint8_t tag = play_log[play_pos];
+        if (tag == REPLAY_CHECKPOINT) {
+            play_pos += 5;
+            continue;
+        }
+        if (tag == REPLAY_TRUNCATED && play_pos + 5 <= play_length) {
+            stats.truncated = true;
+            stats.truncated_tick = replay_read_u32(play_log + play_pos + 1);
+            play_pos += 5;
+            return false;
+        }
+        if (tag & 0x80) {
+            return false;
+        }
+
+        play_pos++;
+        run_inputs = (tag >> 4) & REPLAY_INPUT_MASK;
+        run_length = (tag & 0x0F) + 1;
+        if (run_length == 16) {
+            uint32_t extra = 0;
+            for (uint shift = 0; play_pos < play_length && shift < 32; shift += 7) {
+                uint8_t byte = play_log[play_pos++];
+                extra |= (uint32_t)(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    break;
+                }
+            }
+            run_length += extra;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool replay_tick(uint8_t *inputs) {
+    if (!playing) {
+        uint8_t value = *inputs & REPLAY_INPUT_MASK;
+        if (run_length && value != run_inputs) {
+            replay_flush_run();
+        }
+        run_inputs = value;
+        run_length++;
+        stats.ticks++;
+        return true;
+    }
+
+    if (!run_length && !replay_next_run()) {
+        // O log acabou antes da partida: a reprodução divergiu, a não ser que
+        // a gravação tenha parado aqui por falta de espaço
+        if (!stats.truncated) {
+            replay_mismatch();
+        }
+        return false;
+    }
+    *inputs = run_inputs;
+    run_length--;
+    stats.ticks++;
+    return true;
+}
+
+// Reprodução: confere a checagem gravada neste ponto, se houver
+static void replay_verify(uint32_t hash) {
+    if (run_length || play_pos + 5 > play_length || play_log[play_pos] != REPLAY_CHECKPOINT) {
+        return;
+    }
+    stats.checkpoints++;
+    if (replay_read_u32(play_log + play_pos + 1) != hash) {
+        replay_mismatch();
+    }
+    play_pos += 5;
+}
+
+void replay_check(uint32_t hash) {
+    if (playing) {
+        replay_verify(hash);
+    } else if (stats.ticks % REPLAY_HASH_INTERVAL == 0) {
+        replay_flush_run();
+        replay_put_u32(REPLAY_CHECKPOINT, hash, false);
+        stats.checkpoints += !stats.truncated;
+    }
+}
+
+void replay_finish(uint32_t hash) {
+    if (playing) {
+        // Log truncado: a reprodução parou onde a gravação parou, sem mais nada
+        // a conferir
+        if (stats.truncated) {
+            return;
+        }
+        replay_verify(hash);
+        // A partida reproduzida tem que terminar junto com o log
+        if (run_length || play_pos >= play_length || play_log[play_pos] != REPLAY_END) {
+            replay_mismatch();
+        }
+        return;
+    }
+
+    replay_flush_run();
+    if (stats.truncated) {
+        // O hash do fim da partida não corresponde a nenhum tick do log: no
+        // lugar da última checagem vai a marca de truncado
+        replay_put_u32(REPLAY_TRUNCATED, stats.truncated_tick, true);
+    } else {
+        // Checagem repetida no mesmo tick é inofensiva: a reprodução confere as duas
+        replay_put_u32(REPLAY_CHECKPOINT, hash, true);
+        stats.checkpoints++;
+    }
+    uint8_t end = REPLAY_END;
+    replay_put(&end, 1, true);
+}
+
+const uint8_t *replay_log(size_t *length) {
+    *length = record_length;
+    return record_log;
+}
+
+void replay_dump(void) {
+    printf("replay ");
+    for (size_t i = 0; i < record_length; i++) {
+        printf("%02x", record_log[i]);
+    }
+    printf("\n");
+}
+
+const replay_stats_t *replay_stats(void) {
+    return &stats;
+}
+
+#ifdef DINO_HOST
+bool replay_play_file(const char *path, uint32_t *seed) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+
+    // O log reproduzido fica alocado até o fim do processo
+    static uint8_t *buffer;
+    free(buffer);
+    buffer = malloc(REPLAY_LOG_MAX);
+    size_t length = buffer ? fread(buffer, 1, REPLAY_LOG_MAX, file) : 0;
+    fclose(file);
+    return replay_play_start(buffer, length, seed);
+}
+
+bool replay_save_file(const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = fwrite(record_log, 1, record_length, file) == record_length;
+    fclose(file);
+    return ok;
+}
+#endif
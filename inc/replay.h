@@ -0,0 +1,84 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "hal.h"
+
+#ifndef replay_inc_h
+#define replay_inc_h
+
+//------------------------------------------------------------------------------
+// Gravação e reprodução determinística de partidas
+//------------------------------------------------------------------------------
+// Uma partida fica determinada pela semente do gerador aleatório e pelas
+// entradas de cada tick lógico. O gravador guarda as duas coisas num log
+// compacto em RAM; o reprodutor devolve as entradas gravadas ao loop do jogo,
+// tick a tick, e compara o hash do estado do jogo com os pontos de checagem
+// gravados (a cada REPLAY_HASH_INTERVAL ticks e no fim da partida).
+//
+// Formato do log (inteiros little-endian):
+//   "DRR1" + semente (u32)
+//   0x00..0x7F  sequência: entradas nos bits 6..4 (até 3 botões) e duração-1
+//               nos bits 3..0; duração-1 = 15 é seguida de um varint com o
+//               restante (duração - 16)
+//   0x80 + u32  checagem: hash do estado após o último tick da sequência anterior
+//   0x81        fim do log
+//   0x82 + u32  log truncado: só os ticks até esse (quantidade de ticks
+//               gravados) estão no log; vem logo antes do fim
+//------------------------------------------------------------------------------
+
+// Tamanho do log em RAM; ao encher, a gravação para e o log termina com a
+// marca de truncado (fim e última checagem, ou marca, sempre cabem). A
+// reprodução de um log truncado para nesse tick, sem acusar divergência
+#define REPLAY_LOG_MAX 4096
+// Intervalo, em ticks, entre checagens de hash
+#define REPLAY_HASH_INTERVAL 64
+// Entradas por tick: até 3 bits
+#define REPLAY_INPUT_MASK 0x07
+
+typedef struct {
+    uint32_t ticks;          // Ticks gravados ou reproduzidos
+    uint32_t checkpoints;    // Checagens gravadas ou conferidas
+    uint32_t mismatches;     // Checagens divergentes (ou log que acabou antes)
+    int32_t first_mismatch;  // Tick da primeira divergência (-1 se nenhuma)
+    bool truncated;          // O log encheu na gravação (ou o reproduzido é truncado)
+    uint32_t truncated_tick; // Ticks que cabem no log truncado
+} replay_stats_t;
+
+// Hash (FNV-1a) do estado do jogo, em palavras de 32 bits
+uint32_t replay_hash(const uint32_t *words, size_t count);
+
+// Começa a gravar uma partida com a semente indicada
+void replay_record_start(uint32_t seed);
+
+// Começa a reproduzir um log. Retorna false se o log for inválido
+bool replay_play_start(const uint8_t *log, size_t length, uint32_t *seed);
+
+bool replay_playing(void);
+
+// Uma vez por tick lógico, antes de usar as entradas: na gravação guarda
+// '*inputs'; na reprodução substitui '*inputs' pelas gravadas. Retorna false
+// quando o log reproduzido acabou
+bool replay_tick(uint8_t *inputs);
+
+// Após o tick, com o hash do estado: grava ou confere o ponto de checagem
+void replay_check(uint32_t hash);
+
+// Fim da partida: grava a última checagem e o fim do log, ou confere que o log
+// também termina aqui
+void replay_finish(uint32_t hash);
+
+// Log gravado até agora
+const uint8_t *replay_log(size_t *length);
+
+// Envia o log gravado pelo stdio (USB no Pico) numa linha "replay <hex>"
+void replay_dump(void);
+
+const replay_stats_t *replay_stats(void);
+
+#ifdef DINO_HOST
+// Lê um log de arquivo e começa a reproduzi-lo; grava o log atual em arquivo
+bool replay_play_file(const char *path, uint32_t *seed);
+bool replay_save_file(const char *path);
+#endif
+
+#endif
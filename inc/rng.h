@@ -0,0 +1,43 @@
+#include <stdint.h>
+
+#ifndef rng_inc_h
+#define rng_inc_h
+
+//------------------------------------------------------------------------------
+// Gerador pseudoaleatório rápido (xorshift32)
+//------------------------------------------------------------------------------
+// Substitui rand(): o estado é explícito (cada gerador tem o seu, sem estado
+// global da libc), cabe em uma palavra e cada número custa três deslocamentos
+// e três XORs. A mesma semente gera sempre a mesma sequência, no Pico e no
+// host, o que mantém as partidas reproduzíveis pelo replay.
+//------------------------------------------------------------------------------
+
+typedef struct {
+    uint32_t state;
+} rng_t;
+
+// Espalha a semente (splitmix32) para que sementes próximas gerem sequências
+// diferentes; o estado do xorshift nunca pode ser zero
+static inline void rng_seed(rng_t *rng, uint32_t seed) {
+    uint32_t z = seed + 0x9E3779B9u;
+    z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+    z ^= z >> 16;
+    rng->state = z ? z : 0x6D2B79F5u;
+}
+
+static inline uint32_t rng_next(rng_t *rng) {
+    uint32_t x = rng->state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    rng->state = x;
+    return x;
+}
+
+// Número em [0, n), por multiplicação (sem divisão nem viés de módulo relevante)
+static inline uint32_t rng_below(rng_t *rng, uint32_t n) {
+    return (uint32_t)(((uint64_t)rng_next(rng) * n) >> 32);
+}
+
+#endif
@@ -0,0 +1,59 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef sprite_inc_h
+#define sprite_inc_h
+
+//------------------------------------------------------------------------------
+// Sprites em máscara de bits para a matriz 5x5
+//------------------------------------------------------------------------------
+// Cada camada é uma máscara de ocupação de 25 bits (bit linha * 5 + coluna)
+// mais o índice da sua cor na paleta. A lógica do jogo trabalha só com as
+// máscaras: compor é um OR e colidir é um AND. As cores só são consultadas ao
+// expandir o frame para o buffer de LEDs.
+//------------------------------------------------------------------------------
+
+#define SPRITE_LINHAS 5
+#define SPRITE_COLUNAS 5
+#define SPRITE_PIXELS (SPRITE_LINHAS * SPRITE_COLUNAS)
+
+// Máscara de um único pixel
+#define SPRITE_BIT(linha, coluna) (1u << ((linha) * SPRITE_COLUNAS + (coluna)))
+
+typedef uint32_t sprite_mask_t;
+
+typedef struct {
+  sprite_mask_t mask;
+  uint8_t paleta; // Índice da cor na paleta
+} sprite_t;
+
+// Junta duas máscaras (união dos pixels)
+static inline sprite_mask_t sprite_compoe(sprite_mask_t a, sprite_mask_t b)
+{
+  return a | b;
+}
+
+// Verdadeiro se as duas máscaras têm algum pixel em comum
+static inline bool sprite_colide(sprite_mask_t a, sprite_mask_t b)
+{
+  return (a & b) != 0;
+}
+
+// Expande as camadas (a última fica por cima) em um índice de paleta por
+// pixel; pixels vazios ficam com 0. Percorre apenas os bits acesos.
+static inline void sprite_expande(const sprite_t *camadas, int n, uint8_t saida[SPRITE_PIXELS])
+{
+  for (int i = 0; i < SPRITE_PIXELS; i++)
+  {
+    saida[i] = 0;
+  }
+  for (int c = 0; c < n; c++)
+  {
+    for (sprite_mask_t m = camadas[c].mask; m; m &= m - 1)
+    {
+      saida[__builtin_ctz(m)] = camadas[c].paleta;
+    }
+  }
+}
+
+#endif
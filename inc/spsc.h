@@ -0,0 +1,72 @@
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifndef spsc_inc_h
+#define spsc_inc_h
+
+//------------------------------------------------------------------------------
+// Fila sem trava de um produtor e um consumidor (SPSC)
+//------------------------------------------------------------------------------
+// A fila só controla índices; os dados ficam num vetor de 'capacity' posições
+// mantido pelo usuário. O produtor reserva uma posição, preenche e publica; o
+// consumidor espia a posição mais antiga, lê e libera. Cada índice é escrito
+// por um único lado, então basta ordenar as leituras/escritas (acquire/release)
+// para funcionar entre os dois núcleos do RP2040 ou entre threads no host.
+//------------------------------------------------------------------------------
+
+typedef struct {
+  uint32_t head; // Próxima posição a publicar (escrito só pelo produtor)
+  uint32_t tail; // Próxima posição a consumir (escrito só pelo consumidor)
+  uint32_t capacity;
+} spsc_queue_t;
+
+static inline void spsc_init(spsc_queue_t *q, uint32_t capacity)
+{
+  q->head = 0;
+  q->tail = 0;
+  q->capacity = capacity;
+}
+
+// Produtor: posição livre para preencher, ou -1 se a fila estiver cheia
+static inline int spsc_reserve(spsc_queue_t *q)
+{
+  uint32_t head = q->head;
+  uint32_t tail = __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+  if (head - tail >= q->capacity)
+  {
+    return -1;
+  }
+  return (int)(head % q->capacity);
+}
+
+// Produtor: publica a posição reservada
+static inline void spsc_commit(spsc_queue_t *q)
+{
+  __atomic_store_n(&q->head, q->head + 1, __ATOMIC_RELEASE);
+}
+
+// Consumidor: posição mais antiga publicada, ou -1 se a fila estiver vazia
+static inline int spsc_peek(spsc_queue_t *q)
+{
+  uint32_t tail = q->tail;
+  uint32_t head = __atomic_load_n(&q->head, __ATOMIC_ACQUIRE);
+  if (head == tail)
+  {
+    return -1;
+  }
+  return (int)(tail % q->capacity);
+}
+
+// Consumidor: devolve a posição lida ao produtor
+static inline void spsc_release(spsc_queue_t *q)
+{
+  __atomic_store_n(&q->tail, q->tail + 1, __ATOMIC_RELEASE);
+}
+
+// Qualquer lado: verdadeiro se não há nada publicado pendente
+static inline bool spsc_empty(spsc_queue_t *q)
+{
+  return __atomic_load_n(&q->head, __ATOMIC_ACQUIRE) == __atomic_load_n(&q->tail, __ATOMIC_ACQUIRE);
+}
+
+#endif
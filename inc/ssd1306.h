@@ -1,17 +1,33 @@
 #include "ssd1306_i2c.h"
 extern void calculate_render_area_buffer_length(struct render_area *area);
-extern void ssd1306_send_command(uint8_t cmd);
-extern void ssd1306_send_command_list(uint8_t *ssd, int number);
-extern void ssd1306_send_buffer(uint8_t ssd[], int buffer_length);
-extern void ssd1306_init();
-extern void ssd1306_scroll(bool set);
-extern void render_on_display(uint8_t *ssd, struct render_area *area);
+extern bool ssd1306_tx_begin(uint port, uint8_t address);
+extern bool ssd1306_tx_commands(uint port, const uint8_t *commands, size_t n);
+extern bool ssd1306_tx_data(uint port, const uint8_t *data, size_t n, bool end);
+extern void ssd1306_tx_start(uint port);
+extern const ssd1306_tx_stats_t *ssd1306_tx_stats(uint port);
+extern uint ssd1306_fast_mode_plus(ssd1306_t *ssd, uint baudrate);
+extern void ssd1306_send_command(ssd1306_t *ssd, uint8_t command);
+extern void ssd1306_send_command_list(ssd1306_t *ssd, const uint8_t *commands, int number);
+extern void ssd1306_send_buffer(ssd1306_t *ssd, const uint8_t *data, int buffer_length);
+extern void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, uint i2c);
+extern void ssd1306_config(ssd1306_t *ssd);
+extern void ssd1306_invalidate(ssd1306_t *ssd);
+extern void ssd1306_scroll(ssd1306_t *ssd, bool set);
+extern void ssd1306_scroll_pages(ssd1306_t *ssd, uint8_t start_page, uint8_t end_page, ssd1306_scroll_interval_t interval, bool left);
+extern void ssd1306_scroll_stop(ssd1306_t *ssd);
+extern void render_on_display(ssd1306_t *ssd, struct render_area *area);
+extern uint8_t *ssd1306_buffer(ssd1306_t *ssd);
+extern bool ssd1306_flush_async(ssd1306_t *ssd);
+extern bool ssd1306_flush_busy(ssd1306_t *ssd);
+extern void ssd1306_flush_wait(ssd1306_t *ssd);
+extern void ssd1306_flush(ssd1306_t *ssd);
 extern void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set);
+extern void ssd1306_blit(uint8_t *ssd, int x, int y, const uint8_t *bitmap, int width, int height, ssd1306_rop_t op);
+extern void ssd1306_fill_rect(uint8_t *ssd, int x, int y, int width, int height, bool set, ssd1306_rop_t op);
+extern void ssd1306_draw_hline(uint8_t *ssd, int x, int y, int width, bool set);
+extern void ssd1306_draw_vline(uint8_t *ssd, int x, int y, int height, bool set);
 extern void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set);
 extern void ssd1306_draw_char(uint8_t *ssd, int16_t x, int16_t y, uint8_t character);
 extern void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string);
-extern void ssd1306_command(ssd1306_t *ssd, uint8_t command);
-extern void ssd1306_config(ssd1306_t *ssd);
-extern void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 extern void ssd1306_send_data(ssd1306_t *ssd);
-extern void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap);
\ No newline at end of file
+extern void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap);
@@ -2,110 +2,615 @@
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
-#include "pico/stdlib.h"
-#include "pico/binary_info.h"
-#include "hardware/i2c.h"
+#include "hal.h"
 #include "ssd1306_font.h"
-#include "ssd1306_i2c.h"
+#include "ssd1306.h"
+#include "prof.h"
+
+// Cada ssd1306_t tem o seu barramento, endereço, geometria e dois framebuffers,
+// com o byte de controle 0x40 reservado na posição 0:
+//   - ram_buffer (back): onde se desenha (ssd1306_buffer);
+//   - front: cópia do que já foi enviado (espelho da GDDRAM do display).
+// Cada envio compara o back com o front, transmite só as janelas alteradas e
+// atualiza o front; o back continua com o desenho para o próximo frame. Os
+// framebuffers sempre têm o tamanho do canvas (ssd1306_width x ssd1306_height);
+// num display de 32 linhas só as 4 primeiras páginas são enviadas.
+//
+// Displays em portas diferentes (i2c0 e i2c1) têm transportes e canais DMA
+// independentes: os envios assíncronos correm em paralelo.
+
+// Máscara das páginas [start_page, end_page]
+#define ssd1306_page_mask(start_page, end_page) ((uint8_t)((0xFFu << (start_page)) & (0xFFu >> (7 - (end_page)))))
+
+// Janela retangular (páginas x colunas) a ser retransmitida
+struct ssd1306_window {
+    uint8_t start_column, end_column;
+    uint8_t start_page, end_page;
+};
 
 // Calcular quanto do buffer será destinado à área de renderização
 void calculate_render_area_buffer_length(struct render_area *area) {
     area->buffer_length = (area->end_column - area->start_column + 1) * (area->end_page - area->start_page + 1);
 }
 
-// Processo de escrita do i2c espera um byte de controle, seguido por dados
-void ssd1306_send_command(uint8_t command) {
-    uint8_t buffer[2] = {0x80, command};
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, buffer, 2, false);
+//------------------------------------------------------------------------------
+// Transporte: cada envio vira uma única sequência I2C
+//------------------------------------------------------------------------------
+// Comandos seguidos são juntados numa transação só, com o byte de controle
+// 0x00 (Co = 0: todos os bytes seguintes são comandos). Os dados vão numa
+// transação com 0x40. Dentro de uma transação o controlador não volta de
+// comandos para dados sem um byte de controle por comando, então uma janela
+// custa duas transações curtas (comandos e dados) em vez de 0x80 por comando.
+//------------------------------------------------------------------------------
+
+typedef struct {
+    uint8_t commands[ssd1306_tx_commands_max + 1]; // [0] = byte de controle 0x00
+    size_t n_commands;
+    bool in_data;
+    ssd1306_tx_stats_t stats;
+    ssd1306_tx_stats_t stats_begin; // Contadores na abertura da sequência
+} ssd1306_tx_t;
+
+static ssd1306_tx_t ssd1306_tx[2];
+
+// Abre a sequência da porta. Retorna false se a anterior ainda estiver em envio
+bool __not_in_flash_func(ssd1306_tx_begin)(uint port, uint8_t address) {
+    if (!hal_i2c_async_begin(port, address)) {
+        return false;
+    }
+    ssd1306_tx[port].n_commands = 0;
+    ssd1306_tx[port].in_data = false;
+    ssd1306_tx[port].stats_begin = ssd1306_tx[port].stats;
+    return true;
+}
+
+// Descarta a sequência aberta (que ficou cheia) e a reabre vazia: nada dela
+// foi transmitido, então os contadores voltam aos da abertura
+static void __not_in_flash_func(ssd1306_tx_restart)(uint port, uint8_t address) {
+    ssd1306_tx[port].stats = ssd1306_tx[port].stats_begin;
+    ssd1306_tx_begin(port, address);
 }
 
-// Envia uma lista de comandos ao hardware
-void ssd1306_send_command_list(uint8_t *ssd, int number) {
-    for (int i = 0; i < number; i++) {
-        ssd1306_send_command(ssd[i]);
+// Fecha os comandos acumulados numa transação. Retorna false se a sequência
+// não comportar a transação (HAL_I2C_ASYNC_MAX); os comandos são descartados
+static bool __not_in_flash_func(ssd1306_tx_close_commands)(uint port) {
+    ssd1306_tx_t *tx = &ssd1306_tx[port];
+    if (!tx->n_commands) {
+        return true;
     }
+    tx->commands[0] = 0x00;
+    bool queued = hal_i2c_async_append(port, tx->commands, tx->n_commands + 1, true);
+    if (queued) {
+        tx->stats.transactions++;
+        tx->stats.bytes += tx->n_commands + 1;
+    }
+    tx->n_commands = 0;
+    return queued;
 }
 
-// Copia buffer de referência num novo buffer, a fim de adicionar o byte de controle desde o início
-void ssd1306_send_buffer(uint8_t ssd[], int buffer_length) {
-    uint8_t *temp_buffer = malloc(buffer_length + 1);
+// Acrescenta comandos (e seus argumentos) à transação de comandos aberta.
+// Retorna false se a sequência ficou cheia: ela deve ser descartada
+bool __not_in_flash_func(ssd1306_tx_commands)(uint port, const uint8_t *commands, size_t n) {
+    ssd1306_tx_t *tx = &ssd1306_tx[port];
+    for (size_t i = 0; i < n; i++) {
+        if (tx->n_commands == ssd1306_tx_commands_max && !ssd1306_tx_close_commands(port)) {
+            return false;
+        }
+        tx->commands[1 + tx->n_commands++] = commands[i];
+    }
+    return true;
+}
 
-    temp_buffer[0] = 0x40;
-    memcpy(temp_buffer + 1, ssd, buffer_length);
+// Acrescenta dados para a GDDRAM. Chamadas seguidas formam uma transação, que
+// termina na chamada com 'end'. Retorna false se a sequência ficou cheia
+bool __not_in_flash_func(ssd1306_tx_data)(uint port, const uint8_t *data, size_t n, bool end) {
+    static const uint8_t control = 0x40;
+    ssd1306_tx_t *tx = &ssd1306_tx[port];
 
-    i2c_write_blocking(i2c1, ssd1306_i2c_address, temp_buffer, buffer_length + 1, false);
+    if (!ssd1306_tx_close_commands(port)) {
+        return false;
+    }
+    if (!tx->in_data) {
+        if (!hal_i2c_async_append(port, &control, 1, false)) {
+            return false;
+        }
+        tx->stats.transactions++;
+        tx->stats.bytes++;
+        tx->in_data = true;
+    }
+    if (!hal_i2c_async_append(port, data, n, end)) {
+        return false;
+    }
+    tx->stats.bytes += n;
+    tx->in_data = !end;
+    return true;
+}
+
+// Fecha a sequência e inicia o envio em segundo plano
+void __not_in_flash_func(ssd1306_tx_start)(uint port) {
+    ssd1306_tx_close_commands(port);
+    hal_i2c_async_start(port);
+    ssd1306_tx[port].stats.flushes++;
+}
+
+// Contadores de envios, transações e bytes (após o endereço) da porta
+const ssd1306_tx_stats_t *ssd1306_tx_stats(uint port) {
+    return &ssd1306_tx[port].stats;
+}
 
-    free(temp_buffer);
+// Tenta o Fast-mode Plus (1 MHz): sobe o clock da porta do display e manda um
+// NOP; se o display não confirmar (ACK), volta para 'baudrate'. Retorna o clock
+// em uso. Vale para todos os displays da mesma porta
+uint ssd1306_fast_mode_plus(ssd1306_t *ssd, uint baudrate) {
+    static const uint8_t nop[] = {0x00, ssd1306_set_nop};
+
+    hal_i2c_async_wait(ssd->i2c_port);
+    uint actual = hal_i2c_set_baudrate(ssd->i2c_port, ssd1306_i2c_clock_fast_plus * 1000);
+    ssd1306_tx[ssd->i2c_port].stats.transactions++;
+    ssd1306_tx[ssd->i2c_port].stats.bytes += sizeof(nop);
+    if (hal_i2c_write(ssd->i2c_port, ssd->address, nop, sizeof(nop)) == (int)sizeof(nop)) {
+        return actual;
+    }
+    return hal_i2c_set_baudrate(ssd->i2c_port, baudrate);
 }
 
-// Cria a lista de comandos (com base nos endereços definidos em ssd1306_i2c.h) para a inicialização do display
-void ssd1306_init() {
+// Envia um comando ao display
+void ssd1306_send_command(ssd1306_t *ssd, uint8_t command) {
+    ssd1306_send_command_list(ssd, &command, 1);
+}
+
+// Envia uma lista de comandos ao hardware, numa única transação, e espera o fim
+void ssd1306_send_command_list(ssd1306_t *ssd, const uint8_t *commands, int number) {
+    ssd1306_flush_wait(ssd);
+    ssd1306_tx_begin(ssd->i2c_port, ssd->address);
+    ssd1306_tx_commands(ssd->i2c_port, commands, number);
+    ssd1306_tx_start(ssd->i2c_port);
+    ssd1306_flush_wait(ssd);
+}
+
+// Envia um buffer de dados numa transação, sem cópia para um buffer intermediário
+void ssd1306_send_buffer(ssd1306_t *ssd, const uint8_t *data, int buffer_length) {
+    ssd1306_flush_wait(ssd);
+    ssd1306_tx_begin(ssd->i2c_port, ssd->address);
+    ssd1306_tx_data(ssd->i2c_port, data, buffer_length, true);
+    ssd1306_tx_start(ssd->i2c_port);
+    ssd1306_flush_wait(ssd);
+}
+
+// Descarta o espelho da GDDRAM: o próximo envio transmite a tela inteira
+void ssd1306_invalidate(ssd1306_t *ssd) {
+    ssd->front_valid = 0;
+}
+
+// Lista de comandos de inicialização, conforme a geometria do display
+void ssd1306_config(ssd1306_t *ssd) {
     uint8_t commands[] = {
-        ssd1306_set_display, ssd1306_set_memory_mode, 0x00,
-        ssd1306_set_display_start_line, ssd1306_set_segment_remap | 0x01, 
-        ssd1306_set_mux_ratio, ssd1306_height - 1,
-        ssd1306_set_common_output_direction | 0x08, ssd1306_set_display_offset,
-        0x00, ssd1306_set_common_pin_configuration,
-    
-#if ((ssd1306_width == 128) && (ssd1306_height == 32))
-    0x02,
-#elif ((ssd1306_width == 128) && (ssd1306_height == 64))
-    0x12,
-#else
-    0x02,
-#endif
-        ssd1306_set_display_clock_divide_ratio, 0x80, ssd1306_set_precharge,
-        0xF1, ssd1306_set_vcomh_deselect_level, 0x30, ssd1306_set_contrast,
-        0xFF, ssd1306_set_entire_on, ssd1306_set_normal_display,
-        ssd1306_set_charge_pump, 0x14, ssd1306_set_scroll | 0x00,
+        ssd1306_set_display | 0x00,
+        ssd1306_set_memory_mode, 0x00,
+        ssd1306_set_display_start_line | 0x00,
+        ssd1306_set_segment_remap | 0x01,
+        ssd1306_set_mux_ratio, ssd->height - 1,
+        ssd1306_set_common_output_direction | 0x08,
+        ssd1306_set_display_offset, 0x00,
+        // Pinos COM: sequenciais em 128x32, alternados em 128x64
+        ssd1306_set_common_pin_configuration, ssd->height == 64 ? 0x12 : 0x02,
+        ssd1306_set_display_clock_divide_ratio, 0x80,
+        ssd1306_set_precharge, ssd->external_vcc ? 0x22 : 0xF1,
+        ssd1306_set_vcomh_deselect_level, 0x30,
+        ssd1306_set_contrast, 0xFF,
+        ssd1306_set_entire_on,
+        ssd1306_set_normal_display,
+        ssd1306_set_charge_pump, ssd->external_vcc ? 0x10 : 0x14,
+        ssd1306_set_scroll | 0x00,
         ssd1306_set_display | 0x01,
     };
 
-    ssd1306_send_command_list(commands, count_of(commands));
+    ssd1306_send_command_list(ssd, commands, count_of(commands));
+    ssd->scrolling = 0;
+    ssd1306_invalidate(ssd);
+}
+
+// Prepara um display (128x32 ou 128x64) na porta e endereço indicados e envia
+// a inicialização. A porta já deve ter sido iniciada com hal_i2c_init. O
+// framebuffer começa apagado; nada é enviado a ele até o primeiro flush
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, uint i2c) {
+    ssd->width = MIN(width, ssd1306_width);
+    ssd->height = MIN(height, ssd1306_height);
+    ssd->pages = ssd->height / ssd1306_page_height;
+    ssd->address = address;
+    ssd->i2c_port = i2c;
+    ssd->external_vcc = external_vcc;
+    memset(ssd->ram_buffer, 0, sizeof(ssd->ram_buffer));
+    memset(ssd->front, 0, sizeof(ssd->front));
+    ssd->ram_buffer[0] = 0x40;
+    ssd->front[0] = 0x40;
+    ssd->on_window = NULL;
+    ssd1306_config(ssd);
+}
+
+// Cria a lista de comandos para configurar o scrolling (tela inteira)
+void ssd1306_scroll(ssd1306_t *ssd, bool set) {
+    if (set) {
+        ssd1306_scroll_pages(ssd, 0, ssd->pages - 1, ssd1306_scroll_5_frames, false);
+    } else {
+        ssd1306_scroll_stop(ssd);
+    }
 }
 
-// Cria a lista de comandos para configurar o scrolling
-void ssd1306_scroll(bool set) {
+// Para a rolagem. A GDDRAM das páginas roladas fica deslocada (e o datasheet
+// pede que seja reescrita), então elas voltam a ser enviadas no próximo envio
+void ssd1306_scroll_stop(ssd1306_t *ssd) {
+    ssd1306_send_command(ssd, ssd1306_set_scroll | 0x00);
+    ssd->front_valid &= ~ssd->scrolling;
+    ssd->scrolling = 0;
+}
+
+// Rolagem horizontal contínua das páginas [start_page, end_page], feita pelo
+// próprio controlador: uma coluna a cada 'interval' quadros do display, com a
+// GDDRAM girando em anel (o que sai de um lado entra do outro). As páginas são
+// reescritas a partir do back buffer antes de a rolagem começar e, enquanto
+// ela durar, não são mais enviadas por ssd1306_flush_async. Bloqueia até o fim
+void ssd1306_scroll_pages(ssd1306_t *ssd, uint8_t start_page, uint8_t end_page, ssd1306_scroll_interval_t interval, bool left) {
+    struct render_area area = {
+        .start_column = 0,
+        .end_column = ssd->width - 1,
+        .start_page = start_page,
+        .end_page = end_page
+    };
+    calculate_render_area_buffer_length(&area);
+
+    ssd1306_flush_wait(ssd);
+    if (ssd->scrolling) {
+        ssd1306_scroll_stop(ssd);
+    }
+    ssd->front_valid &= ~ssd1306_page_mask(start_page, end_page);
+    render_on_display(ssd, &area);
+
     uint8_t commands[] = {
-        ssd1306_set_horizontal_scroll | 0x00, 0x00, 0x00, 0x00, 0x03,
-        0x00, 0xFF, ssd1306_set_scroll | (set ? 0x01 : 0)
+        ssd1306_set_horizontal_scroll | (left ? 0x01 : 0x00), 0x00, start_page, interval, end_page,
+        0x00, 0xFF, ssd1306_set_scroll | 0x01
     };
+    ssd1306_send_command_list(ssd, commands, count_of(commands));
 
-    ssd1306_send_command_list(commands, count_of(commands));
+    ssd->scrolling = ssd1306_page_mask(start_page, end_page);
+    ssd->front_valid &= ~ssd->scrolling;
 }
 
-// Atualiza uma parte do display com uma área de renderização
-void render_on_display(uint8_t *ssd, struct render_area *area) {
+// Enfileira uma janela: endereços de coluna/página numa transação de comandos
+// e depois os dados, lidos do front, numa transação de dados. Retorna false se
+// a sequência ficou cheia
+static bool __not_in_flash_func(ssd1306_queue_window)(ssd1306_t *ssd, const struct ssd1306_window *window) {
     uint8_t commands[] = {
-        ssd1306_set_column_address, area->start_column, area->end_column,
-        ssd1306_set_page_address, area->start_page, area->end_page
+        ssd1306_set_column_address, window->start_column, window->end_column,
+        ssd1306_set_page_address, window->start_page, window->end_page
     };
+    int width = window->end_column - window->start_column + 1;
+
+    if (!ssd1306_tx_commands(ssd->i2c_port, commands, count_of(commands))) {
+        return false;
+    }
+
+    if (ssd->on_window) {
+        struct render_area area = {
+            .start_column = window->start_column,
+            .end_column = window->end_column,
+            .start_page = window->start_page,
+            .end_page = window->end_page
+        };
+        calculate_render_area_buffer_length(&area);
+        ssd->on_window(ssd, &area);
+    }
+
+    // Janela com a largura do framebuffer: as páginas são contínuas no front
+    if (width == ssd1306_width) {
+        return ssd1306_tx_data(ssd->i2c_port, ssd->front + 1 + window->start_page * ssd1306_width,
+                               (window->end_page - window->start_page + 1) * ssd1306_width, true);
+    }
+    for (int page = window->start_page; page <= window->end_page; page++) {
+        if (!ssd1306_tx_data(ssd->i2c_port, ssd->front + 1 + page * ssd1306_width + window->start_column,
+                             width, page == window->end_page)) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    ssd1306_send_command_list(commands, count_of(commands));
-    ssd1306_send_buffer(ssd, area->buffer_length);
+// Custo em bytes (dados + overhead de endereçamento) de uma janela
+static int __not_in_flash_func(ssd1306_window_cost)(const struct ssd1306_window *window) {
+    return (window->end_column - window->start_column + 1) *
+           (window->end_page - window->start_page + 1) + ssd1306_window_overhead;
 }
 
-// Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida
+// Compara uma área do back com o front, copia as janelas alteradas para o
+// front e as enfileira na sequência I2C aberta. Retorna a quantidade de janelas,
+// ou -1 se a sequência ficou cheia (o front já tem a área nova, mas o display não)
+static int __not_in_flash_func(ssd1306_queue_area)(ssd1306_t *ssd, const struct render_area *area) {
+    uint8_t area_pages = ssd1306_page_mask(area->start_page, area->end_page);
+    bool valid = (ssd->front_valid & area_pages) == area_pages;
+    // Cada trecho ocupa ao menos 1 coluna seguida de um intervalo > overhead
+    struct ssd1306_window windows[ssd1306_n_pages * (ssd1306_width / (ssd1306_window_overhead + 1) + 1)];
+    int count = 0;
+    int cost = 0;
+    // Janela da página anterior que ainda pode crescer para baixo
+    int open = -1;
+
+    for (int page = area->start_page; page <= area->end_page && valid; page++) {
+        const uint8_t *row = ssd->ram_buffer + 1 + page * ssd1306_width;
+        const uint8_t *shadow = ssd->front + 1 + page * ssd1306_width;
+        int first_span = count;
+
+        // Procura trechos alterados; trechos próximos (intervalo menor que o
+        // custo de abrir uma nova janela) são unidos em um só
+        for (int col = area->start_column; col <= area->end_column; col++) {
+            if (row[col] == shadow[col]) {
+                continue;
+            }
+            int start = col;
+            int end = col;
+            for (col++; col <= area->end_column; col++) {
+                if (row[col] != shadow[col]) {
+                    end = col;
+                } else if (col - end > ssd1306_window_overhead) {
+                    break;
+                }
+            }
+            windows[count] = (struct ssd1306_window){start, end, page, page};
+            cost += ssd1306_window_cost(&windows[count++]);
+        }
+
+        // Um único trecho nesta página: tenta estender a janela da página de
+        // cima, se um retângulo só ficar mais barato que duas janelas
+        if (count - first_span == 1 && open >= 0 && windows[open].end_page == page - 1) {
+            struct ssd1306_window merged = windows[open];
+            struct ssd1306_window *span = &windows[first_span];
+            merged.start_column = MIN(merged.start_column, span->start_column);
+            merged.end_column = MAX(merged.end_column, span->end_column);
+            merged.end_page = page;
+            int separate = ssd1306_window_cost(&windows[open]) + ssd1306_window_cost(span);
+            if (ssd1306_window_cost(&merged) <= separate) {
+                cost += ssd1306_window_cost(&merged) - separate;
+                windows[open] = merged;
+                count--;
+                continue;
+            }
+        }
+        open = count - first_span == 1 ? first_span : -1;
+    }
+
+    // Espelho inválido ou alterações espalhadas demais: envia a área toda
+    struct ssd1306_window all = {
+        area->start_column, area->end_column, area->start_page, area->end_page
+    };
+    if (!valid || cost >= ssd1306_window_cost(&all)) {
+        windows[0] = all;
+        count = 1;
+    }
+
+    int area_width = area->end_column - area->start_column + 1;
+    for (int page = area->start_page; page <= area->end_page; page++) {
+        int offset = 1 + page * ssd1306_width + area->start_column;
+        memcpy(ssd->front + offset, ssd->ram_buffer + offset, area_width);
+    }
+    for (int i = 0; i < count; i++) {
+        if (!ssd1306_queue_window(ssd, &windows[i])) {
+            return -1;
+        }
+    }
+
+    // Só a área enviada é conhecida: uma página passa a valer se foi enviada inteira
+    if (area->start_column == 0 && area->end_column == ssd->width - 1) {
+        ssd->front_valid |= area_pages;
+    }
+    return count;
+}
+
+// Atualiza uma parte do display com a mesma área do framebuffer, transmitindo
+// apenas o que mudou desde o último envio. Bloqueia até o fim da transferência
+void render_on_display(ssd1306_t *ssd, struct render_area *area) {
+    ssd1306_flush_wait(ssd);
+    ssd1306_tx_begin(ssd->i2c_port, ssd->address);
+    if (ssd1306_queue_area(ssd, area) < 0) {
+        // Janelas demais para a sequência: reenvia a área inteira
+        ssd1306_invalidate(ssd);
+        ssd1306_tx_restart(ssd->i2c_port, ssd->address);
+        ssd1306_queue_area(ssd, area);
+    }
+    ssd1306_tx_start(ssd->i2c_port);
+    ssd1306_flush_wait(ssd);
+}
+
+// Framebuffer (canvas inteiro, sem o byte de controle) onde se desenha
+uint8_t *ssd1306_buffer(ssd1306_t *ssd) {
+    return ssd->ram_buffer + 1;
+}
+
+// Enfileira as páginas fora da rolagem pelo controlador, uma área por trecho
+// contínuo. Retorna a quantidade de janelas, ou -1 se a sequência ficou cheia
+static int __not_in_flash_func(ssd1306_queue_pages)(ssd1306_t *ssd) {
+    int windows = 0;
+    struct render_area area = {.start_column = 0, .end_column = ssd->width - 1};
+
+    for (int page = 0; page < ssd->pages; page++) {
+        if (ssd->scrolling & (1 << page)) {
+            continue;
+        }
+        area.start_page = page;
+        while (page + 1 < ssd->pages && !(ssd->scrolling & (1 << (page + 1)))) {
+            page++;
+        }
+        area.end_page = page;
+        calculate_render_area_buffer_length(&area);
+        int count = ssd1306_queue_area(ssd, &area);
+        if (count < 0) {
+            return -1;
+        }
+        windows += count;
+    }
+    return windows;
+}
+
+// Inicia o envio do framebuffer por DMA e retorna sem esperar. Retorna false
+// (sem enviar nada) se a transferência anterior da porta ainda estiver em
+// andamento. Páginas em rolagem pelo controlador ficam de fora
+bool __not_in_flash_func(ssd1306_flush_async)(ssd1306_t *ssd) {
+    if (!ssd1306_tx_begin(ssd->i2c_port, ssd->address)) {
+        return false;
+    }
+    uint32_t prof_start = prof_begin();
+    int windows = ssd1306_queue_pages(ssd);
+    if (windows < 0) {
+        // Janelas demais para a sequência (HAL_I2C_ASYNC_MAX): descarta o que
+        // foi enfileirado e reenvia as páginas inteiras, que sempre cabem (o
+        // canvas tem 1024 bytes, mais os endereços de cada área)
+        ssd1306_invalidate(ssd);
+        ssd1306_tx_restart(ssd->i2c_port, ssd->address);
+        windows = ssd1306_queue_pages(ssd);
+    }
+    if (windows > 0) {
+        ssd1306_tx_start(ssd->i2c_port);
+    }
+    prof_end(PROF_OLED_FLUSH, prof_start);
+    return windows >= 0;
+}
+
+// Indica se ainda há uma transferência em andamento na porta do display
+bool ssd1306_flush_busy(ssd1306_t *ssd) {
+    return hal_i2c_async_busy(ssd->i2c_port);
+}
+
+// Espera a transferência em andamento terminar
+void ssd1306_flush_wait(ssd1306_t *ssd) {
+    hal_i2c_async_wait(ssd->i2c_port);
+}
+
+// Envia o framebuffer e espera o fim
+void ssd1306_flush(ssd1306_t *ssd) {
+    ssd1306_flush_wait(ssd);
+    ssd1306_flush_async(ssd);
+    ssd1306_flush_wait(ssd);
+}
+
+// Determina o pixel a ser aceso (no display) de acordo com a coordenada fornecida.
+// Pixels fora da tela são ignorados
 void ssd1306_set_pixel(uint8_t *ssd, int x, int y, bool set) {
-    assert(x >= 0 && x < ssd1306_width && y >= 0 && y < ssd1306_height);
+    if ((unsigned)x >= ssd1306_width || (unsigned)y >= ssd1306_height) {
+        return;
+    }
 
-    const int bytes_per_row = ssd1306_width;
+    uint8_t *byte = &ssd[(y >> 3) * ssd1306_width + x];
+    uint8_t bit = 1 << (y & 7);
+    *byte = set ? *byte | bit : *byte & ~bit;
+}
 
-    int byte_idx = (y / 8) * bytes_per_row + x;
-    uint8_t byte = ssd[byte_idx];
+// Combina um byte do framebuffer com um byte de origem; só os bits de 'mask'
+// podem mudar
+static inline uint8_t ssd1306_rop(uint8_t dst, uint8_t src, uint8_t mask, ssd1306_rop_t op) {
+    switch (op) {
+    case ssd1306_rop_or:
+        return dst | (src & mask);
+    case ssd1306_rop_and:
+        return dst & (src | ~mask);
+    case ssd1306_rop_xor:
+        return dst ^ (src & mask);
+    default:
+        return (dst & ~mask) | (src & mask);
+    }
+}
 
-    if (set) {
-        byte |= 1 << (y % 8);
+// Copia um bitmap 1bpp para o framebuffer em qualquer (x, y), com recorte nas
+// bordas. O bitmap tem o mesmo formato do framebuffer e da fonte: páginas de
+// 8 linhas com 'width' bytes cada, bit 0 em cima. Com y fora do múltiplo de 8,
+// cada byte de origem é deslocado e dividido entre duas páginas do destino
+void __not_in_flash_func(ssd1306_blit)(uint8_t *ssd, int x, int y, const uint8_t *bitmap, int width, int height, ssd1306_rop_t op) {
+    // Colunas visíveis do bitmap: [first, last)
+    int first = x < 0 ? -x : 0;
+    int last = MIN(width, ssd1306_width - x);
+    if (first >= last || height <= 0 || y >= ssd1306_height || y + height <= 0) {
+        return;
     }
-    else {
-        byte &= ~(1 << (y % 8));
+
+    int count = last - first;
+    int pages = (height + 7) / 8;
+    int shift = y & 7;
+    int page = (y - shift) / 8;
+
+    // Páginas de origem que caem inteiramente acima da tela
+    int p = page < -1 ? -1 - page : 0;
+    for (page += p; p < pages && page < (int)ssd1306_n_pages; p++, page++) {
+        const uint8_t *src = bitmap + p * width + first;
+        uint8_t mask = p == pages - 1 && height % 8 ? (1 << (height % 8)) - 1 : 0xFF;
+
+        // Parte de cima de cada byte: desce 'shift' linhas na página 'page'
+        uint8_t mask_low = mask << shift;
+        if (page >= 0 && mask_low) {
+            uint8_t *dst = ssd + page * ssd1306_width + x + first;
+            for (int i = 0; i < count; i++) {
+                dst[i] = ssd1306_rop(dst[i], src[i] << shift, mask_low, op);
+            }
+        }
+
+        // Parte de baixo: o que passou da página vai para o topo da seguinte
+        uint8_t mask_high = shift ? mask >> (8 - shift) : 0;
+        if (page + 1 < (int)ssd1306_n_pages && mask_high) {
+            uint8_t *dst = ssd + (page + 1) * ssd1306_width + x + first;
+            for (int i = 0; i < count; i++) {
+                dst[i] = ssd1306_rop(dst[i], src[i] >> (8 - shift), mask_high, op);
+            }
+        }
     }
+}
+
+// Preenche um retângulo com a cor 'set', combinada pela operação 'op' (ex.:
+// copy apaga ou acende, xor com set inverte). Cada página é tratada de uma vez
+// com uma máscara das linhas cobertas, sem cálculo por pixel
+void ssd1306_fill_rect(uint8_t *ssd, int x, int y, int width, int height, bool set, ssd1306_rop_t op) {
+    int x_0 = MAX(x, 0);
+    int x_1 = MIN(x + width, ssd1306_width);
+    int y_0 = MAX(y, 0);
+    int y_1 = MIN(y + height, ssd1306_height);
+    if (x_0 >= x_1 || y_0 >= y_1) {
+        return;
+    }
+
+    uint8_t src = set ? 0xFF : 0x00;
+    for (int page = y_0 >> 3; page <= (y_1 - 1) >> 3; page++) {
+        int top = MAX(y_0 - page * 8, 0);
+        int bottom = MIN(y_1 - page * 8, 8);
+        uint8_t mask = (0xFF << top) & (0xFF >> (8 - bottom));
+        uint8_t *dst = ssd + page * ssd1306_width;
+
+        if (mask == 0xFF && op == ssd1306_rop_copy) {
+            memset(dst + x_0, src, x_1 - x_0);
+            continue;
+        }
+        for (int col = x_0; col < x_1; col++) {
+            dst[col] = ssd1306_rop(dst[col], src, mask, op);
+        }
+    }
+}
+
+// Linha horizontal: um bit por coluna, na mesma página
+void ssd1306_draw_hline(uint8_t *ssd, int x, int y, int width, bool set) {
+    ssd1306_fill_rect(ssd, x, y, width, 1, set, ssd1306_rop_copy);
+}
 
-    ssd[byte_idx] = byte;
+// Linha vertical: um byte (ou parte dele) por página
+void ssd1306_draw_vline(uint8_t *ssd, int x, int y, int height, bool set) {
+    ssd1306_fill_rect(ssd, x, y, 1, height, set, ssd1306_rop_copy);
 }
 
 // Algoritmo de Bresenham básico
 void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool set) {
+    // Linhas retas viram spans, preenchidos página a página
+    if (y_0 == y_1) {
+        ssd1306_draw_hline(ssd, MIN(x_0, x_1), y_0, abs(x_1 - x_0) + 1, set);
+        return;
+    }
+    if (x_0 == x_1) {
+        ssd1306_draw_vline(ssd, x_0, MIN(y_0, y_1), abs(y_1 - y_0) + 1, set);
+        return;
+    }
+
     int dx = abs(x_1 - x_0); // Deslocamentos
     int dy = -abs(y_1 - y_0);
     int sx = x_0 < x_1 ? 1 : -1; // Direção de avanço
@@ -133,7 +638,7 @@ void ssd1306_draw_line(uint8_t *ssd, int x_0, int y_0, int x_1, int y_1, bool se
 }
 
 // Adquire os pixels para um caractere (de acordo com ssd1306_font.h)
-inline int ssd1306_get_font(uint8_t character)
+static inline int ssd1306_get_font(uint8_t character)
 {
   if (character >= 'A' && character <= 'Z') {
     return character - 'A' + 1;
@@ -145,101 +650,36 @@ inline int ssd1306_get_font(uint8_t character)
     return 0;
 }
 
-// Desenha um único caractere no display
-void ssd1306_draw_char(uint8_t *ssd, int16_t x, int16_t y, uint8_t character) {
-    if (x > ssd1306_width - 8 || y > ssd1306_height - 8) {
-        return;
-    }
-
-    y = y / 8;
-
+// Desenha um único caractere no display, em qualquer posição (recortado nas bordas)
+void __not_in_flash_func(ssd1306_draw_char)(uint8_t *ssd, int16_t x, int16_t y, uint8_t character) {
     character = toupper(character);
     int idx = ssd1306_get_font(character);
-    int fb_idx = y * 128 + x;
-
-    for (int i = 0; i < 8; i++) {
-        ssd[fb_idx++] = font[idx * 8 + i];
-    }
+    ssd1306_blit(ssd, x, y, &font[idx * 8], 8, 8, ssd1306_rop_copy);
 }
 
 // Desenha uma string, chamando a função de desenhar caractere várias vezes
-void ssd1306_draw_string(uint8_t *ssd, int16_t x, int16_t y, char *string) {
-    if (x > ssd1306_width - 8 || y > ssd1306_height - 8) {
+void __not_in_flash_func(ssd1306_draw_string)(uint8_t *ssd, int16_t x, int16_t y, char *string) {
+    if (y <= -8 || y >= ssd1306_height) {
         return;
     }
 
-    while (*string) {
+    while (*string && x < ssd1306_width) {
         ssd1306_draw_char(ssd, x, y, *string++);
         x += 8;
     }
 }
 
-// Comando de configuração com base na estrutura ssd1306_t
-void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
-  ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-	ssd->i2c_port, ssd->address, ssd->port_buffer, 2, false );
-}
-
-// Função de configuração do display para o caso do bitmap
-void ssd1306_config(ssd1306_t *ssd) {
-    ssd1306_command(ssd, ssd1306_set_display | 0x00);
-    ssd1306_command(ssd, ssd1306_set_memory_mode);
-    ssd1306_command(ssd, 0x01);
-    ssd1306_command(ssd, ssd1306_set_display_start_line | 0x00);
-    ssd1306_command(ssd, ssd1306_set_segment_remap | 0x01);
-    ssd1306_command(ssd, ssd1306_set_mux_ratio);
-    ssd1306_command(ssd, ssd1306_height - 1);
-    ssd1306_command(ssd, ssd1306_set_common_output_direction | 0x08);
-    ssd1306_command(ssd, ssd1306_set_display_offset);
-    ssd1306_command(ssd, 0x00);
-    ssd1306_command(ssd, ssd1306_set_common_pin_configuration);
-    ssd1306_command(ssd, 0x12);
-    ssd1306_command(ssd, ssd1306_set_display_clock_divide_ratio);
-    ssd1306_command(ssd, 0x80);
-    ssd1306_command(ssd, ssd1306_set_precharge);
-    ssd1306_command(ssd, 0xF1);
-    ssd1306_command(ssd, ssd1306_set_vcomh_deselect_level);
-    ssd1306_command(ssd, 0x30);
-    ssd1306_command(ssd, ssd1306_set_contrast);
-    ssd1306_command(ssd, 0xFF);
-    ssd1306_command(ssd, ssd1306_set_entire_on);
-    ssd1306_command(ssd, ssd1306_set_normal_display);
-    ssd1306_command(ssd, ssd1306_set_charge_pump);
-    ssd1306_command(ssd, 0x14);
-    ssd1306_command(ssd, ssd1306_set_display | 0x01);
-}
-
-// Inicializa o display para o caso de exibição de bitmap
-void ssd1306_init_bm(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
-    ssd->width = width;
-    ssd->height = height;
-    ssd->pages = height / 8U;
-    ssd->address = address;
-    ssd->i2c_port = i2c;
-    ssd->bufsize = ssd->pages * ssd->width + 1;
-    ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
-    ssd->ram_buffer[0] = 0x40;
-    ssd->port_buffer[0] = 0x80;
-}
-
-// Envia os dados ao display
+// Envia o framebuffer inteiro ao display e espera o fim
 void ssd1306_send_data(ssd1306_t *ssd) {
-    ssd1306_command(ssd, ssd1306_set_column_address);
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->width - 1);
-    ssd1306_command(ssd, ssd1306_set_page_address);
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->pages - 1);
-    i2c_write_blocking(
-    ssd->i2c_port, ssd->address, ssd->ram_buffer, ssd->bufsize, false );
+    ssd1306_invalidate(ssd);
+    ssd1306_flush(ssd);
 }
 
-// Desenha o bitmap (a ser fornecido em display_oled.c) no display
+// Desenha o bitmap (mesmo formato do framebuffer: páginas de 'width' bytes) no
+// display: copia o frame inteiro e envia só o que mudou
 void ssd1306_draw_bitmap(ssd1306_t *ssd, const uint8_t *bitmap) {
-    for (int i = 0; i < ssd->bufsize - 1; i++) {
-        ssd->ram_buffer[i + 1] = bitmap[i];
-
-        ssd1306_send_data(ssd);
+    for (int page = 0; page < ssd->pages; page++) {
+        memcpy(ssd->ram_buffer + 1 + page * ssd1306_width, bitmap + page * ssd->width, ssd->width);
     }
+    ssd1306_flush(ssd);
 }
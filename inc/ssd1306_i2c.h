@@ -1,16 +1,18 @@
 #include <stdlib.h>
-#include "pico/stdlib.h"
-#include "hardware/i2c.h"
+#include "hal.h"
 
 #ifndef ssd1306_inc_h
 #define ssd1306_inc_h
 
-#define ssd1306_height 64 // Define a altura do display (32 pixels)
+// Canvas dos framebuffers: a maior geometria aceita (displays de 128x32 usam
+// só as 4 primeiras páginas)
+#define ssd1306_height 64 // Define a altura máxima do display (64 pixels)
 #define ssd1306_width 128 // Define a largura do display (128 pixels)
 
 #define ssd1306_i2c_address _u(0x3C) // Define o endereço do i2c do display
 
 #define ssd1306_i2c_clock 400 // Define o tempo do clock (pode ser aumentado)
+#define ssd1306_i2c_clock_fast_plus 1000 // Fast-mode Plus, se o display aceitar
 
 // Comandos de configuração (endereços)
 #define ssd1306_set_memory_mode _u(0x20)
@@ -39,14 +41,52 @@
 #define ssd1306_set_precharge _u(0xD9)
 #define ssd1306_set_common_pin_configuration _u(0xDA)
 #define ssd1306_set_vcomh_deselect_level _u(0xDB)
+#define ssd1306_set_nop _u(0xE3)
 
 #define ssd1306_page_height _u(8)
 #define ssd1306_n_pages (ssd1306_height / ssd1306_page_height)
 #define ssd1306_buffer_length (ssd1306_n_pages * ssd1306_width)
 
+// Custo aproximado, em bytes de I2C, de abrir uma nova janela de coluna/página:
+// transação de comandos (endereço, 0x00 e 6 bytes), endereço e 0x40 dos dados
+// e cerca de um byte de START/STOP por transação
+#define ssd1306_window_overhead 12
+
+// Comandos acumulados numa transação antes de ela ser fechada e outra aberta
+#define ssd1306_tx_commands_max 32
+
 #define ssd1306_write_mode _u(0xFE)
 #define ssd1306_read_mode _u(0xFF)
 
+// Operações de combinação do blit: como cada bit da origem afeta o framebuffer
+// (só dentro do retângulo desenhado; o resto não é tocado)
+typedef enum {
+    ssd1306_rop_copy, // Substitui: o pixel fica igual à origem
+    ssd1306_rop_or,   // Acende onde a origem é 1
+    ssd1306_rop_and,  // Apaga onde a origem é 0
+    ssd1306_rop_xor   // Inverte onde a origem é 1
+} ssd1306_rop_t;
+
+// Intervalo entre os passos da rolagem horizontal, em quadros do display (o
+// SSD1306 atualiza a tela a ~100 Hz com o divisor de clock padrão)
+typedef enum {
+    ssd1306_scroll_2_frames = 0x07,
+    ssd1306_scroll_3_frames = 0x04,
+    ssd1306_scroll_4_frames = 0x05,
+    ssd1306_scroll_5_frames = 0x00,
+    ssd1306_scroll_25_frames = 0x06,
+    ssd1306_scroll_64_frames = 0x01,
+    ssd1306_scroll_128_frames = 0x02,
+    ssd1306_scroll_256_frames = 0x03
+} ssd1306_scroll_interval_t;
+
+// Contadores do transporte de uma porta
+typedef struct {
+    uint32_t flushes;      // Sequências enviadas
+    uint32_t transactions; // Transações I2C (START ... STOP)
+    uint64_t bytes;        // Bytes após o endereço: controle, comandos e dados
+} ssd1306_tx_stats_t;
+
 struct render_area {
     uint8_t start_column;
     uint8_t end_column;
@@ -56,13 +96,20 @@ struct render_area {
     int buffer_length;
 };
 
-typedef struct {
+// Um display: barramento, endereço, geometria e framebuffers próprios. Pode ser
+// alocado estaticamente; ssd1306_init preenche todos os campos
+typedef struct ssd1306 ssd1306_t;
+struct ssd1306 {
   uint8_t width, height, pages, address;
-  i2c_inst_t * i2c_port;
+  uint i2c_port; // HAL_I2C0 ou HAL_I2C1
   bool external_vcc;
-  uint8_t *ram_buffer;
-  size_t bufsize;
-  uint8_t port_buffer[2];
-} ssd1306_t;
+  uint8_t ram_buffer[ssd1306_buffer_length + 1]; // Back buffer, [0] = 0x40
+  uint8_t front[ssd1306_buffer_length + 1];      // Espelho da GDDRAM, [0] = 0x40
+  uint8_t front_valid; // Páginas (bits) em que o front confere com a GDDRAM
+  uint8_t scrolling;   // Páginas (bits) em rolagem pelo controlador
+  // Chamada para cada janela enviada (já copiada para o front), ou NULL; serve
+  // para espelhar o display fora da placa
+  void (*on_window)(const ssd1306_t *ssd, const struct render_area *window);
+};
 
 #endif
\ No newline at end of file
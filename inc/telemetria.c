@@ -0,0 +1,366 @@
+#include <string.h>
+#include "telemetria.h"
+
+#define TELEMETRIA_ESTADO_BYTES (23 + 4 * OBSTACULOS_TIPOS)
+
+// Buffer circular de um produtor: quadros precedidos do tamanho (u16)
+typedef struct {
+    uint8_t bytes[TELEMETRIA_CANAL_BYTES];
+    uint32_t head; // Bytes escritos (só pelo produtor)
+    uint32_t tail; // Bytes lidos (só pelo consumidor)
+    // Pacote e quadro em montagem (só pelo produtor)
+    uint8_t pacote[TELEMETRIA_PACOTE_MAX];
+    uint8_t quadro[TELEMETRIA_QUADRO_MAX];
+} telemetria_canal_t;
+
+static telemetria_canal_t canais[TELEMETRIA_CANAIS];
+// Sequência de cada tipo (cada tipo tem um só produtor)
+static uint16_t sequencias[TELEMETRIA_TIPOS];
+static telemetria_stats_t stats;
+
+// Consumidor: canal e bytes restantes do quadro sendo enviado
+static uint canal_atual;
+static uint32_t restante;
+
+// Canal de cada tipo
+static const uint8_t telemetria_canal_do_tipo[TELEMETRIA_TIPOS] = {
+    [TELEMETRIA_ESTADO] = TELEMETRIA_CANAL_LOGICA,
+    [TELEMETRIA_LEDS] = TELEMETRIA_CANAL_RENDER,
+    [TELEMETRIA_OLED] = TELEMETRIA_CANAL_RENDER,
+};
+
+// CRC-16/CCITT (polinômio 0x1021, início 0xFFFF), meio byte por vez
+static uint16_t telemetria_crc16(const uint8_t *bytes, size_t length) {
+    static const uint16_t tabela[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    };
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc = (uint16_t)(crc << 4) ^ tabela[(crc >> 12) ^ (bytes[i] >> 4)];
+        crc = (uint16_t)(crc << 4) ^ tabela[(crc >> 12) ^ (bytes[i] & 0x0F)];
+    }
+    return crc;
+}
+
+static uint8_t *telemetria_put_u16(uint8_t *bytes, uint16_t value) {
+    bytes[0] = value;
+    bytes[1] = value >> 8;
+    return bytes + 2;
+}
+
+static uint8_t *telemetria_put_u32(uint8_t *bytes, uint32_t value) {
+    bytes[0] = value;
+    bytes[1] = value >> 8;
+    bytes[2] = value >> 16;
+    bytes[3] = value >> 24;
+    return bytes + 4;
+}
+
+static uint16_t telemetria_get_u16(const uint8_t *bytes) {
+    return bytes[0] | bytes[1] << 8;
+}
+
+static uint32_t telemetria_get_u32(const uint8_t *bytes) {
+    return bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+// COBS: cada trecho sem zeros vira (tamanho + 1) seguido do trecho; trechos de
+// 254 bytes não consomem um zero. Retorna o tamanho codificado
+static size_t telemetria_cobs(const uint8_t *src, size_t length, uint8_t *dst) {
+    size_t codigo = 0;
+    size_t n = 1;
+    for (size_t i = 0; i < length; i++) {
+        if (src[i]) {
+            dst[n++] = src[i];
+        }
+        if (!src[i] || n - codigo == 0xFF) {
+            dst[codigo] = (uint8_t)(n - codigo);
+            codigo = n++;
+        }
+    }
+    dst[codigo] = (uint8_t)(n - codigo);
+    return n;
+}
+
+void telemetria_init(void) {
+    memset(canais, 0, sizeof(canais));
+    memset(sequencias, 0, sizeof(sequencias));
+    memset(&stats, 0, sizeof(stats));
+    canal_atual = 0;
+    restante = 0;
+}
+
+// Dados do pacote em montagem no canal do tipo
+static uint8_t *telemetria_dados(uint tipo) {
+    return canais[telemetria_canal_do_tipo[tipo]].pacote + TELEMETRIA_CABECALHO;
+}
+
+// Fecha o pacote (cabeçalho e CRC), codifica o quadro e o põe no buffer do
+// canal inteiro ou não põe nada
+static bool telemetria_publica(uint tipo, size_t tamanho) {
+    telemetria_canal_t *canal = &canais[telemetria_canal_do_tipo[tipo]];
+    uint8_t *p = canal->pacote;
+    p[0] = (uint8_t)tipo;
+    telemetria_put_u16(p + 1, sequencias[tipo]++);
+    telemetria_put_u32(p + 3, (uint32_t)hal_time_us());
+    size_t n = TELEMETRIA_CABECALHO + tamanho;
+    telemetria_put_u16(p + n, telemetria_crc16(p, n));
+    n += TELEMETRIA_CRC;
+
+    canal->quadro[0] = 0;
+    size_t quadro = 1 + telemetria_cobs(p, n, canal->quadro + 1);
+    canal->quadro[quadro++] = 0;
+
+    uint32_t head = canal->head;
+    uint32_t tail = __atomic_load_n(&canal->tail, __ATOMIC_ACQUIRE);
+    if (TELEMETRIA_CANAL_BYTES - (head - tail) < quadro + 2) {
+        stats.descartados[tipo]++;
+        return false;
+    }
+
+    uint8_t tamanho_quadro[2];
+    telemetria_put_u16(tamanho_quadro, (uint16_t)quadro);
+    for (uint i = 0; i < 2; i++) {
+        canal->bytes[head++ % TELEMETRIA_CANAL_BYTES] = tamanho_quadro[i];
+    }
+    // Até duas cópias: antes e depois da volta do buffer
+    uint32_t inicio = head % TELEMETRIA_CANAL_BYTES;
+    size_t primeiro = MIN(quadro, (size_t)(TELEMETRIA_CANAL_BYTES - inicio));
+    memcpy(canal->bytes + inicio, canal->quadro, primeiro);
+    memcpy(canal->bytes, canal->quadro + primeiro, quadro - primeiro);
+    __atomic_store_n(&canal->head, head + quadro, __ATOMIC_RELEASE);
+    stats.enviados[tipo]++;
+    return true;
+}
+
+bool telemetria_estado(const telemetria_estado_t *estado) {
+    uint8_t *inicio = telemetria_dados(TELEMETRIA_ESTADO);
+    uint8_t *p = telemetria_put_u32(inicio, estado->tick);
+    *p++ = estado->entradas;
+    *p++ = estado->botoes;
+    *p++ = estado->colidiu;
+    p = telemetria_put_u32(p, estado->desviados);
+    p = telemetria_put_u32(p, (uint32_t)estado->altura);
+    p = telemetria_put_u32(p, estado->periodo_us);
+    p = telemetria_put_u32(p, estado->dino);
+    for (uint tipo = 0; tipo < OBSTACULOS_TIPOS; tipo++) {
+        p = telemetria_put_u32(p, estado->inimigos[tipo]);
+    }
+    return telemetria_publica(TELEMETRIA_ESTADO, p - inicio);
+}
+
+bool telemetria_leds(const uint32_t *grb, uint largura, uint altura) {
+    uint total = largura * altura;
+    bool publicado = true;
+    for (uint primeiro = 0; primeiro < total; primeiro += TELEMETRIA_LEDS_MAX) {
+        uint n = MIN(total - primeiro, (uint)TELEMETRIA_LEDS_MAX);
+        uint8_t *inicio = telemetria_dados(TELEMETRIA_LEDS);
+        uint8_t *p = telemetria_put_u16(inicio, (uint16_t)largura);
+        p = telemetria_put_u16(p, (uint16_t)altura);
+        p = telemetria_put_u16(p, (uint16_t)primeiro);
+        p = telemetria_put_u16(p, (uint16_t)n);
+        for (uint i = 0; i < n; i++) {
+            uint32_t led = grb[primeiro + i];
+            *p++ = led >> 24;
+            *p++ = led >> 16;
+            *p++ = led >> 8;
+        }
+        publicado &= telemetria_publica(TELEMETRIA_LEDS, p - inicio);
+    }
+    return publicado;
+}
+
+bool telemetria_oled(uint porta, uint coluna_inicial, uint coluna_final, uint pagina_inicial,
+                     uint pagina_final, const uint8_t *framebuffer) {
+    uint8_t *inicio = telemetria_dados(TELEMETRIA_OLED);
+    uint8_t *p = inicio;
+    *p++ = (uint8_t)porta;
+    *p++ = (uint8_t)coluna_inicial;
+    *p++ = (uint8_t)coluna_final;
+    *p++ = (uint8_t)pagina_inicial;
+    *p++ = (uint8_t)pagina_final;
+    uint largura = coluna_final - coluna_inicial + 1;
+    for (uint pagina = pagina_inicial; pagina <= pagina_final; pagina++) {
+        memcpy(p, framebuffer + pagina * TELEMETRIA_OLED_LARGURA + coluna_inicial, largura);
+        p += largura;
+    }
+    return telemetria_publica(TELEMETRIA_OLED, p - inicio);
+}
+
+void telemetria_envia(void) {
+    while (true) {
+        // Entre quadros: o próximo canal com dados, em rodízio
+        if (!restante) {
+            uint i;
+            for (i = 0; i < TELEMETRIA_CANAIS; i++) {
+                uint c = (canal_atual + 1 + i) % TELEMETRIA_CANAIS;
+                if (__atomic_load_n(&canais[c].head, __ATOMIC_ACQUIRE) != canais[c].tail) {
+                    canal_atual = c;
+                    break;
+                }
+            }
+            if (i == TELEMETRIA_CANAIS) {
+                return;
+            }
+            telemetria_canal_t *canal = &canais[canal_atual];
+            uint8_t tamanho[2];
+            for (uint b = 0; b < 2; b++) {
+                tamanho[b] = canal->bytes[(canal->tail + b) % TELEMETRIA_CANAL_BYTES];
+            }
+            restante = telemetria_get_u16(tamanho);
+            __atomic_store_n(&canal->tail, canal->tail + 2, __ATOMIC_RELEASE);
+        }
+
+        // Trecho contínuo do quadro atual, até onde a serial aceitar
+        telemetria_canal_t *canal = &canais[canal_atual];
+        uint32_t inicio = canal->tail % TELEMETRIA_CANAL_BYTES;
+        size_t n = MIN((size_t)restante, (size_t)(TELEMETRIA_CANAL_BYTES - inicio));
+        size_t aceitos = hal_serial_write(canal->bytes + inicio, n);
+        __atomic_store_n(&canal->tail, canal->tail + (uint32_t)aceitos, __ATOMIC_RELEASE);
+        restante -= (uint32_t)aceitos;
+        stats.bytes += aceitos;
+        if (aceitos < n) {
+            return;
+        }
+    }
+}
+
+bool telemetria_pendente(void) {
+    for (uint c = 0; c < TELEMETRIA_CANAIS; c++) {
+        if (__atomic_load_n(&canais[c].head, __ATOMIC_ACQUIRE) != canais[c].tail) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool telemetria_quadro_aberto(void) {
+    return restante != 0;
+}
+
+const telemetria_stats_t *telemetria_stats(void) {
+    return &stats;
+}
+
+void telemetria_decodificador_init(telemetria_decodificador_t *d,
+                                   void (*pacote)(const telemetria_pacote_t *pacote, void *contexto),
+                                   void (*texto)(const uint8_t *bytes, size_t tamanho, void *contexto),
+                                   void *contexto) {
+    memset(d, 0, sizeof(*d));
+    d->pacote = pacote;
+    d->texto = texto;
+    d->contexto = contexto;
+}
+
+// Desfaz o COBS. Retorna o tamanho decodificado ou 0 se o quadro for inválido
+static size_t telemetria_des_cobs(const uint8_t *src, size_t length, uint8_t *dst, size_t max) {
+    size_t n = 0;
+    size_t i = 0;
+    while (i < length) {
+        uint8_t codigo = src[i++];
+        if (!codigo || i + codigo - 1 > length) {
+            return 0;
+        }
+        for (uint k = 1; k < codigo; k++) {
+            if (n == max) {
+                return 0;
+            }
+            dst[n++] = src[i++];
+        }
+        // O zero implícito não existe no fim do quadro nem depois de 254 bytes
+        if (codigo != 0xFF && i < length) {
+            if (n == max) {
+                return 0;
+            }
+            dst[n++] = 0;
+        }
+    }
+    return n;
+}
+
+// Texto: só caracteres imprimíveis, espaços e UTF-8
+static bool telemetria_eh_texto(const uint8_t *bytes, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (bytes[i] < 0x20 && bytes[i] != '\n' && bytes[i] != '\r' && bytes[i] != '\t') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Um trecho entre delimitadores: pacote, texto ou lixo
+static void telemetria_trecho(telemetria_decodificador_t *d) {
+    size_t n = d->transbordou ? 0 : telemetria_des_cobs(d->quadro, d->tamanho, d->pacote_bytes,
+                                                         sizeof(d->pacote_bytes));
+    if (n >= TELEMETRIA_CABECALHO + TELEMETRIA_CRC &&
+        telemetria_get_u16(d->pacote_bytes + n - TELEMETRIA_CRC) ==
+            telemetria_crc16(d->pacote_bytes, n - TELEMETRIA_CRC) &&
+        d->pacote_bytes[0] && d->pacote_bytes[0] < TELEMETRIA_TIPOS) {
+        telemetria_pacote_t pacote = {
+            .tipo = d->pacote_bytes[0],
+            .sequencia = telemetria_get_u16(d->pacote_bytes + 1),
+            .tempo_us = telemetria_get_u32(d->pacote_bytes + 3),
+            .dados = d->pacote_bytes + TELEMETRIA_CABECALHO,
+            .tamanho = n - TELEMETRIA_CABECALHO - TELEMETRIA_CRC,
+        };
+        // Buracos na sequência: pacotes descartados na placa
+        if (d->recebido[pacote.tipo]) {
+            d->perdidos += (uint16_t)(pacote.sequencia - d->ultima_sequencia[pacote.tipo] - 1);
+        }
+        d->recebido[pacote.tipo] = true;
+        d->ultima_sequencia[pacote.tipo] = pacote.sequencia;
+        d->pacotes++;
+        if (d->pacote) {
+            d->pacote(&pacote, d->contexto);
+        }
+    } else if (!d->transbordou && telemetria_eh_texto(d->quadro, d->tamanho)) {
+        d->texto_bytes += d->tamanho;
+        if (d->texto) {
+            d->texto(d->quadro, d->tamanho, d->contexto);
+        }
+    } else {
+        d->invalidos++;
+    }
+    d->tamanho = 0;
+    d->transbordou = false;
+}
+
+void telemetria_decodifica(telemetria_decodificador_t *d, const uint8_t *bytes, size_t tamanho) {
+    for (size_t i = 0; i < tamanho; i++) {
+        if (!bytes[i]) {
+            if (d->tamanho || d->transbordou) {
+                telemetria_trecho(d);
+            }
+        } else if (d->tamanho < sizeof(d->quadro)) {
+            d->quadro[d->tamanho++] = bytes[i];
+        } else {
+            d->transbordou = true;
+        }
+    }
+}
+
+void telemetria_decodifica_fim(telemetria_decodificador_t *d) {
+    if (d->tamanho || d->transbordou) {
+        telemetria_trecho(d);
+    }
+}
+
+bool telemetria_le_estado(const telemetria_pacote_t *pacote, telemetria_estado_t *estado) {
+    if (pacote->tipo != TELEMETRIA_ESTADO || pacote->tamanho != TELEMETRIA_ESTADO_BYTES) {
+        return false;
+    }
+    const uint8_t *p = pacote->dados;
+    estado->tick = telemetria_get_u32(p);
+    estado->entradas = p[4];
+    estado->botoes = p[5];
+    estado->colidiu = p[6];
+    estado->desviados = telemetria_get_u32(p + 7);
+    estado->altura = (int32_t)telemetria_get_u32(p + 11);
+    estado->periodo_us = telemetria_get_u32(p + 15);
+    estado->dino = telemetria_get_u32(p + 19);
+    for (uint tipo = 0; tipo < OBSTACULOS_TIPOS; tipo++) {
+        estado->inimigos[tipo] = telemetria_get_u32(p + 23 + 4 * tipo);
+    }
+    return true;
+}
@@ -0,0 +1,161 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "hal.h"
+#include "sprite.h"
+#include "obstaculos.h"
+
+#ifndef telemetria_inc_h
+#define telemetria_inc_h
+
+//------------------------------------------------------------------------------
+// Telemetria binária pela serial (USB CDC do stdio)
+//------------------------------------------------------------------------------
+// O jogo publica pacotes com o estado de cada tick, os frames dos LEDs e as
+// janelas do OLED enviadas ao display. Cada pacote vira um quadro num buffer
+// circular em RAM, e telemetria_envia passa os bytes para a serial só
+// enquanto ela aceita sem bloquear. Com o buffer cheio, o pacote novo é
+// descartado (e contado) em vez de segurar o loop.
+//
+// Há um buffer por produtor, cada um de um só núcleo, como a fila de frames:
+// TELEMETRIA_CANAL_LOGICA (estado, no loop do jogo) e TELEMETRIA_CANAL_RENDER
+// (LEDs e OLED, no renderizador). telemetria_envia é o único consumidor dos
+// dois e troca de buffer só entre quadros.
+//
+// Quadro: 0x00, pacote codificado em COBS, 0x00. O COBS tira os zeros do
+// pacote, então 0x00 só aparece como delimitador e o decodificador se
+// ressincroniza no próximo. Um quadro pode sair em vários pedaços, conforme
+// a serial aceita: quem escreve texto na mesma serial (printf) deve esperar
+// telemetria_quadro_aberto ficar falso. Assim o texto, que não tem zeros,
+// fica entre os quadros e o decodificador o separa como texto.
+//
+// Pacote (inteiros little-endian):
+//   tipo (u8), sequência (u16, contada por tipo, também nos descartados),
+//   tempo (u32, us desde o boot), dados, CRC-16/CCITT (u16) do que vem antes
+//
+// Dados de cada tipo:
+//   TELEMETRIA_ESTADO: tick (u32), entradas do tick (u8), botões mantidos (u8,
+//     bit 0 pulo, bit 1 abaixar), colidiu (u8), desviados (u32), altura do
+//     dino (i32, Q16.16), período dos inimigos (u32, us), máscara do dino (u32)
+//     e uma máscara por tipo de inimigo (u32 cada)
+//   TELEMETRIA_LEDS: largura (u16), altura (u16), primeiro LED (u16),
+//     quantidade (u16) e G, R, B de cada LED, na ordem da fiação. Matrizes
+//     grandes vão em vários pacotes
+//   TELEMETRIA_OLED: porta (u8), coluna inicial e final (u8), página inicial
+//     e final (u8) e os bytes da janela, página a página
+//------------------------------------------------------------------------------
+
+enum {
+    TELEMETRIA_ESTADO = 1,
+    TELEMETRIA_LEDS,
+    TELEMETRIA_OLED,
+    TELEMETRIA_TIPOS
+};
+
+enum {
+    TELEMETRIA_CANAL_LOGICA,
+    TELEMETRIA_CANAL_RENDER,
+    TELEMETRIA_CANAIS
+};
+
+// Cabeçalho e CRC de um pacote
+#define TELEMETRIA_CABECALHO 7
+#define TELEMETRIA_CRC 2
+// Maior pacote: uma janela do OLED com a tela inteira
+#define TELEMETRIA_DADOS_MAX (5 + 1024)
+#define TELEMETRIA_PACOTE_MAX (TELEMETRIA_CABECALHO + TELEMETRIA_DADOS_MAX + TELEMETRIA_CRC)
+// Quadro: delimitadores e um byte de COBS a cada 254
+#define TELEMETRIA_QUADRO_MAX (TELEMETRIA_PACOTE_MAX + TELEMETRIA_PACOTE_MAX / 254 + 3)
+// Largura do framebuffer do OLED (ssd1306_width)
+#define TELEMETRIA_OLED_LARGURA 128
+// LEDs por pacote
+#define TELEMETRIA_LEDS_MAX 256
+// Tamanho de cada buffer circular: cabe mais de uma tela inteira do OLED
+#define TELEMETRIA_CANAL_BYTES 4096
+
+typedef struct {
+    uint32_t tick;
+    uint8_t entradas;
+    uint8_t botoes;
+    bool colidiu;
+    uint32_t desviados;
+    int32_t altura;
+    uint32_t periodo_us;
+    sprite_mask_t dino;
+    sprite_mask_t inimigos[OBSTACULOS_TIPOS];
+} telemetria_estado_t;
+
+typedef struct {
+    uint32_t enviados[TELEMETRIA_TIPOS];    // Pacotes colocados no buffer
+    uint32_t descartados[TELEMETRIA_TIPOS]; // Pacotes perdidos com o buffer cheio
+    uint64_t bytes;                         // Bytes aceitos pela serial
+} telemetria_stats_t;
+
+//------------------------------------------------------------------------------
+// Envio (placa)
+//------------------------------------------------------------------------------
+
+void telemetria_init(void);
+
+// Produtores: montam o pacote e o põem no buffer do canal do tipo. Retornam
+// false se ele foi descartado
+bool telemetria_estado(const telemetria_estado_t *estado);
+bool telemetria_leds(const uint32_t *grb, uint largura, uint altura);
+// Janela do OLED, lida de um framebuffer de 128 colunas página a página
+bool telemetria_oled(uint porta, uint coluna_inicial, uint coluna_final, uint pagina_inicial,
+                     uint pagina_final, const uint8_t *framebuffer);
+
+// Consumidor: passa para a serial o que ela aceitar agora, sem bloquear
+void telemetria_envia(void);
+// Ainda há bytes nos buffers
+bool telemetria_pendente(void);
+// Um quadro foi enviado só em parte: o próximo byte na serial tem que ser dele
+bool telemetria_quadro_aberto(void);
+
+const telemetria_stats_t *telemetria_stats(void);
+
+//------------------------------------------------------------------------------
+// Recepção (host)
+//------------------------------------------------------------------------------
+
+typedef struct {
+    uint8_t tipo;
+    uint16_t sequencia;
+    uint32_t tempo_us;
+    const uint8_t *dados;
+    size_t tamanho;
+} telemetria_pacote_t;
+
+typedef struct {
+    // Chamados para cada pacote íntegro e para cada trecho de texto
+    void (*pacote)(const telemetria_pacote_t *pacote, void *contexto);
+    void (*texto)(const uint8_t *bytes, size_t tamanho, void *contexto);
+    void *contexto;
+
+    uint8_t quadro[TELEMETRIA_QUADRO_MAX];
+    size_t tamanho;
+    bool transbordou;
+    uint8_t pacote_bytes[TELEMETRIA_PACOTE_MAX];
+
+    bool recebido[TELEMETRIA_TIPOS];
+    uint16_t ultima_sequencia[TELEMETRIA_TIPOS];
+
+    uint32_t pacotes;   // Pacotes íntegros
+    uint32_t invalidos; // Quadros com COBS, tamanho ou CRC errados
+    uint32_t perdidos;  // Pacotes que faltaram na sequência (descartados na placa)
+    uint64_t texto_bytes;
+} telemetria_decodificador_t;
+
+void telemetria_decodificador_init(telemetria_decodificador_t *d,
+                                   void (*pacote)(const telemetria_pacote_t *pacote, void *contexto),
+                                   void (*texto)(const uint8_t *bytes, size_t tamanho, void *contexto),
+                                   void *contexto);
+// Bytes do fluxo, em qualquer fatiamento
+void telemetria_decodifica(telemetria_decodificador_t *d, const uint8_t *bytes, size_t tamanho);
+// Fim do fluxo: entrega o que sobrou depois do último delimitador
+void telemetria_decodifica_fim(telemetria_decodificador_t *d);
+
+// Lê os dados de um pacote TELEMETRIA_ESTADO. Retorna false se o tamanho não confere
+bool telemetria_le_estado(const telemetria_pacote_t *pacote, telemetria_estado_t *estado);
+
+#endif
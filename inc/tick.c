@@ -0,0 +1,68 @@
+#include "tick.h"
+
+static tick_stats_t stats;
+// Ticks gerados pelo timer e ainda não consumidos (escrito na interrupção)
+static volatile uint32_t pending;
+static bool fast_forward;
+static void (*idle_callback)(void);
+
+static void __not_in_flash_func(tick_callback)(void) {
+    pending++;
+}
+
+void tick_init(uint32_t period_us) {
+    stats = (tick_stats_t){.period_us = period_us};
+    pending = 0;
+    hal_timer_start(period_us, tick_callback);
+}
+
+uint __not_in_flash_func(tick_wait)(void) {
+    if (fast_forward) {
+        stats.ticks++;
+        return 1;
+    }
+
+    while (pending == 0) {
+        if (idle_callback) {
+            idle_callback();
+        }
+        if (pending == 0) {
+            hal_wait_event();
+        }
+    }
+
+    // Consome os ticks pendentes de forma atômica em relação ao timer
+    uint32_t save = hal_irq_disable();
+    uint32_t due = pending;
+    pending = 0;
+    hal_irq_restore(save);
+
+    if (due > stats.max_backlog) {
+        stats.max_backlog = due;
+    }
+    if (due > 1) {
+        stats.late += due - 1;
+    }
+    if (due > TICK_MAX_CATCHUP) {
+        stats.dropped += due - TICK_MAX_CATCHUP;
+        due = TICK_MAX_CATCHUP;
+    }
+    stats.ticks += due;
+    return due;
+}
+
+void tick_set_idle(void (*idle)(void)) {
+    idle_callback = idle;
+}
+
+void tick_set_fast_forward(bool enabled) {
+    fast_forward = enabled;
+}
+
+uint32_t tick_elapsed_ms(void) {
+    return (uint32_t)((uint64_t)stats.ticks * stats.period_us / 1000);
+}
+
+const tick_stats_t *tick_stats(void) {
+    return &stats;
+}
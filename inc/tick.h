@@ -0,0 +1,48 @@
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal.h"
+
+#ifndef tick_inc_h
+#define tick_inc_h
+
+//------------------------------------------------------------------------------
+// Relógio do jogo com passo lógico fixo
+//------------------------------------------------------------------------------
+// Um timer de hardware gera um tick a cada período; o loop principal espera os
+// ticks e roda uma atualização lógica por tick, independente do tempo gasto na
+// renderização. Se um frame atrasa, as atualizações pendentes são recuperadas
+// de uma vez (até TICK_MAX_CATCHUP); o excedente é descartado e contabilizado.
+//------------------------------------------------------------------------------
+
+// Máximo de atualizações lógicas recuperadas em uma única espera
+#define TICK_MAX_CATCHUP 4
+
+typedef struct {
+    uint32_t period_us;
+    uint32_t ticks;       // Atualizações lógicas entregues ao jogo
+    uint32_t late;        // Ticks entregues com atraso (recuperados em lote)
+    uint32_t dropped;     // Ticks descartados por excederem TICK_MAX_CATCHUP
+    uint32_t max_backlog; // Maior quantidade de ticks pendentes em uma espera
+} tick_stats_t;
+
+// Inicia o timer periódico
+void tick_init(uint32_t period_us);
+
+// Espera o próximo tick e retorna quantas atualizações lógicas rodar (>= 1)
+uint tick_wait(void);
+
+// Trabalho de fundo feito enquanto tick_wait espera, a cada vez que o núcleo
+// acorda sem tick pendente (no Pico, a cada interrupção, como o quadro USB de
+// 1 ms). Deve ser curto e não bloquear; NULL desliga
+void tick_set_idle(void (*idle)(void));
+
+// Avanço rápido (reprodução de partidas): tick_wait não espera o timer e
+// entrega um tick por chamada, mantendo o tempo lógico
+void tick_set_fast_forward(bool enabled);
+
+// Tempo lógico decorrido (ticks entregues * período), em milissegundos
+uint32_t tick_elapsed_ms(void);
+
+const tick_stats_t *tick_stats(void);
+
+#endif
@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "hal.h"
+#include "anim.h"
+
+//------------------------------------------------------------------------------
+// Codificador de animações para o display (só no build host)
+//------------------------------------------------------------------------------
+// Lê uma sequência de imagens PBM (P1 ou P4, todas do mesmo tamanho, 128x64
+// ou 128x32, a geometria do display) e escreve no stdout um cabeçalho C com a animação no formato
+// de inc/anim.h, pronta para ficar na flash:
+//
+//   dino_anim [--ms 50] [--name anim] frame0.pbm frame1.pbm ... > anim.h
+//
+// O resumo (bytes crus e codificados) vai para o stderr.
+//------------------------------------------------------------------------------
+
+// O player (anim_start) só aceita frames com a geometria do display: a
+// largura do canvas do SSD1306 e 4 ou 8 páginas
+#define ANIM_TOOL_WIDTH 128
+#define ANIM_TOOL_MIN_PAGES 4
+#define ANIM_TOOL_MAX_PAGES 8
+#define ANIM_TOOL_MAX_BYTES (ANIM_TOOL_WIDTH * ANIM_TOOL_MAX_PAGES)
+
+// Próximo inteiro do cabeçalho PBM, pulando espaços e comentários
+static int pbm_int(FILE *file) {
+    int c;
+    for (;;) {
+        c = fgetc(file);
+        if (c == '#') {
+            while (c != '\n' && c != EOF) {
+                c = fgetc(file);
+            }
+        } else if (!isspace(c)) {
+            break;
+        }
+    }
+    int value = 0;
+    if (!isdigit(c)) {
+        return -1;
+    }
+    while (isdigit(c)) {
+        value = value * 10 + (c - '0');
+        c = fgetc(file);
+    }
+    return value;
+}
+
+// Lê um PBM e o converte para a ordem do framebuffer (página a página, 'w'
+// bytes por página, bit 0 em cima). Retorna false em erro
+static bool pbm_read(const char *path, int *width, int *height, uint8_t *out) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "dino_anim: não foi possível abrir %s\n", path);
+        return false;
+    }
+
+    char magic[2] = {0};
+    bool ok = fread(magic, 1, 2, file) == 2 && magic[0] == 'P' && (magic[1] == '1' || magic[1] == '4');
+    int w = ok ? pbm_int(file) : -1;
+    int h = ok ? pbm_int(file) : -1;
+    if (w != ANIM_TOOL_WIDTH || (h != ANIM_TOOL_MIN_PAGES * 8 && h != ANIM_TOOL_MAX_PAGES * 8)) {
+        fprintf(stderr, "dino_anim: %s: esperado PBM de %dx%d ou %dx%d (o display)\n", path, ANIM_TOOL_WIDTH,
+                ANIM_TOOL_MAX_PAGES * 8, ANIM_TOOL_WIDTH, ANIM_TOOL_MIN_PAGES * 8);
+        fclose(file);
+        return false;
+    }
+
+    int pages = h / 8;
+    memset(out, 0, (size_t)w * pages);
+    for (int y = 0; y < h && ok; y++) {
+        int byte = 0;
+        for (int x = 0; x < w; x++) {
+            int bit;
+            if (magic[1] == '1') {
+                // P1: um dígito por pixel, com ou sem espaços entre eles
+                int c;
+                do {
+                    c = fgetc(file);
+                } while (isspace(c));
+                bit = c - '0';
+                ok = bit == 0 || bit == 1;
+            } else {
+                if (x % 8 == 0) {
+                    byte = fgetc(file);
+                    ok = byte != EOF;
+                }
+                bit = (byte >> (7 - x % 8)) & 1;
+            }
+            if (bit == 1) {
+                out[(y / 8) * w + x] |= 1 << (y % 8);
+            }
+        }
+    }
+    fclose(file);
+
+    if (!ok) {
+        fprintf(stderr, "dino_anim: %s: dados incompletos\n", path);
+        return false;
+    }
+    if ((*width && *width != w) || (*height && *height != h)) {
+        fprintf(stderr, "dino_anim: %s: tamanho diferente do primeiro frame\n", path);
+        return false;
+    }
+    *width = w;
+    *height = h;
+    return true;
+}
+
+// Escreve bytes no vetor C, 16 por linha
+static void emit(const uint8_t *bytes, size_t length) {
+    static size_t column;
+    for (size_t i = 0; i < length; i++, column++) {
+        printf("%s0x%02X,", column % 16 ? " " : "\n    ", bytes[i]);
+    }
+}
+
+int main(int argc, char **argv) {
+    int period_ms = 50;
+    const char *name = "anim";
+    int first = 1;
+
+    while (first < argc && strncmp(argv[first], "--", 2) == 0) {
+        if (strcmp(argv[first], "--ms") == 0 && first + 1 < argc) {
+            period_ms = atoi(argv[first + 1]);
+        } else if (strcmp(argv[first], "--name") == 0 && first + 1 < argc) {
+            name = argv[first + 1];
+        } else {
+            break;
+        }
+        first += 2;
+    }
+    int frames = argc - first;
+    if (frames <= 0 || frames > 0xFFFF || period_ms <= 0 || period_ms > 0xFFFF) {
+        fprintf(stderr, "uso: %s [--ms período] [--name nome] frame.pbm...\n", argv[0]);
+        return 2;
+    }
+
+    static uint8_t prev[ANIM_TOOL_MAX_BYTES], cur[ANIM_TOOL_MAX_BYTES];
+    static uint8_t encoded[ANIM_FRAME_MAX(ANIM_TOOL_MAX_BYTES)];
+    int width = 0, height = 0;
+    size_t raw = 0, total = 0;
+
+    printf("// Gerado por tools/dino_anim.c: %d frames, %d ms por frame\n", frames, period_ms);
+    printf("static const uint8_t %s[] = {", name);
+
+    for (int f = 0; f < frames; f++) {
+        if (!pbm_read(argv[first + f], &width, &height, cur)) {
+            return 1;
+        }
+        size_t length = (size_t)width * (height / 8);
+
+        if (f == 0) {
+            uint8_t header[ANIM_HEADER_BYTES];
+            size_t n = anim_encode_header(header, (uint8_t)width, (uint8_t)(height / 8), (uint16_t)frames,
+                                          (uint16_t)period_ms);
+            emit(header, n);
+            total += n;
+        }
+        size_t n = anim_encode_frame(prev, cur, length, encoded, sizeof(encoded));
+        emit(encoded, n);
+        total += n;
+
+        memcpy(prev, cur, length);
+        raw += length;
+    }
+    printf("\n};\n");
+
+    fprintf(stderr, "dino_anim: %d frames %dx%d, %zu bytes crus, %zu codificados (%.1f%%)\n", frames, width,
+            height, raw, total, raw ? total * 100.0 / raw : 0);
+    return 0;
+}
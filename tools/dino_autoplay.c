@@ -0,0 +1,472 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "hal.h"
+#include "rng.h"
+#include "jogo.h"
+
+//------------------------------------------------------------------------------
+// Autoplayer: simula partidas para calibrar a curva de dificuldade (host)
+//------------------------------------------------------------------------------
+// Cada partida roda jogo_passo (inc/jogo.h), o mesmo passo do jogo, contra um
+// bot de busca com tempo de reação. Nada de HAL ou relógio: uma partida de
+// minutos leva milissegundos, e as sementes independentes são distribuídas
+// entre todos os núcleos.
+//
+// Bot: enxerga o jogo com 'reação' ms de atraso (mais um sorteio de até
+// 'jitter' ms a cada tick). A partir do estado atrasado, ele refaz os ticks
+// desde então com as entradas que já deu (sem os inimigos que surgiram nesse
+// meio-tempo, que ele ainda não viu) e simula planos curtos até BOT_HORIZONTE
+// ticks à frente: esperar alguns ticks e então pular ou abaixar por outros
+// tantos. Fica com o primeiro plano que sobrevive ao horizonte, na ordem de
+// preferência (não fazer nada, depois esperar o máximo possível); se nenhum
+// sobrevive, com o que dura mais. Ele decide de novo quando vê um inimigo
+// novo, antes da próxima ação do plano ou a cada BOT_ATENCAO ticks.
+//
+// Conjuntos de parâmetros: produto cartesiano das listas de --inicial,
+// --minimo, --reducao (ms) e --intervalo (s), os mesmos números que o jogo usa
+// (inc/jogo.c). Todos os conjuntos rodam as mesmas sementes. A saída tem uma
+// linha por conjunto com as distribuições de sobrevida (s) e placar:
+//
+//   dino_autoplay --runs 10000 --inicial 150,200,250 --reacao 200 --jitter 50
+//------------------------------------------------------------------------------
+
+#define AUTOPLAY_MAX_VALORES 16
+#define AUTOPLAY_MAX_THREADS 256
+
+// Bot: maior atraso de reação (ticks), horizonte e intervalo de atenção
+#define BOT_MAX_ATRASO 128
+#define BOT_HORIZONTE 80
+#define BOT_ATENCAO 10
+
+typedef struct {
+    uint8_t espera; // Ticks sem entrada antes da ação
+    uint8_t entradas;
+    uint8_t ticks;  // Ticks com a ação mantida
+} bot_plano_t;
+
+// Esperas (da maior para a menor) e ações de cada plano
+static const uint8_t bot_esperas[] = {20, 10, 5, 0};
+static const bot_plano_t bot_acoes[] = {
+    {0, ENTRADA_PULO, 1},
+    {0, ENTRADA_PULO, 8},
+    {0, ENTRADA_PULO, 20},
+    {0, ENTRADA_PULO, 40},
+    {0, ENTRADA_ABAIXAR, 10},
+    {0, ENTRADA_ABAIXAR, 25},
+    {0, ENTRADA_ABAIXAR, 50},
+};
+
+// Planos em ordem de preferência: nada, e depois cada ação, esperando o máximo
+#define BOT_PLANOS (1 + count_of(bot_esperas) * count_of(bot_acoes))
+static bot_plano_t bot_planos[BOT_PLANOS];
+
+static void bot_init_planos(void) {
+    uint n = 0;
+    bot_planos[n++] = (bot_plano_t){0, 0, 0};
+    for (uint e = 0; e < count_of(bot_esperas); e++) {
+        for (uint a = 0; a < count_of(bot_acoes); a++) {
+            bot_planos[n] = bot_acoes[a];
+            bot_planos[n++].espera = bot_esperas[e];
+        }
+    }
+}
+
+typedef struct {
+    uint dificuldade;
+    uint reacao_ms;
+    uint jitter_ms;
+    uint32_t max_ticks;
+    uint32_t semente;
+} autoplay_config_t;
+
+typedef struct {
+    uint32_t ticks;     // Ticks sobrevividos
+    uint32_t desviados; // Placar
+} autoplay_resultado_t;
+
+static autoplay_config_t config = {
+    .dificuldade = 0,
+    .reacao_ms = 200,
+    .jitter_ms = 50,
+    .max_ticks = 300 * 1000000 / FISICA_PASSO_US,
+    .semente = 1,
+};
+
+static fisica_curva_t conjuntos[AUTOPLAY_MAX_VALORES * AUTOPLAY_MAX_VALORES * AUTOPLAY_MAX_VALORES *
+                                AUTOPLAY_MAX_VALORES];
+static uint n_conjuntos;
+static uint32_t runs = 1000;
+static autoplay_resultado_t *resultados; // [conjunto * runs + partida]
+
+//------------------------------------------------------------------------------
+// Bot
+//------------------------------------------------------------------------------
+
+typedef struct {
+    // Estados e entradas dos últimos ticks (anel), para a visão atrasada
+    jogo_t vistos[BOT_MAX_ATRASO];
+    uint8_t entradas[BOT_MAX_ATRASO];
+    uint32_t tick;
+
+    // Plano em andamento
+    uint8_t plano_entradas;
+    uint32_t plano_fim;
+    uint32_t proxima_decisao;
+    uint32_t gerados_vistos;
+    rng_t rng;
+} bot_t;
+
+// Ticks que o plano sobrevive a partir de 'j' (BOT_HORIZONTE se não colidir)
+static uint bot_simula(const jogo_t *j, const bot_plano_t *plano) {
+    jogo_t sim = *j;
+    for (uint t = 0; t < BOT_HORIZONTE; t++) {
+        jogo_passo(&sim, t >= plano->espera && t < plano->espera + plano->ticks ? plano->entradas : 0);
+        if (sim.colidiu) {
+            return t;
+        }
+    }
+    return BOT_HORIZONTE;
+}
+
+static void bot_decide(bot_t *bot, uint atraso) {
+    // O que o bot vê: o estado de 'atraso' ticks atrás, sem novos inimigos,
+    // avançado com as entradas que ele mesmo deu desde então
+    jogo_t previsto = bot->vistos[(bot->tick - atraso) % BOT_MAX_ATRASO];
+    bot->gerados_vistos = previsto.inimigos.gerados;
+    previsto.inimigos.n_padroes = 0;
+    for (uint32_t t = bot->tick - atraso; t < bot->tick && !previsto.colidiu; t++) {
+        jogo_passo(&previsto, bot->entradas[t % BOT_MAX_ATRASO]);
+    }
+
+    uint melhor = 0;
+    uint melhor_sobrevida = 0;
+    for (uint i = 0; i < BOT_PLANOS; i++) {
+        uint sobrevida = bot_simula(&previsto, &bot_planos[i]);
+        if (sobrevida > melhor_sobrevida) {
+            melhor = i;
+            melhor_sobrevida = sobrevida;
+        }
+        if (sobrevida == BOT_HORIZONTE) {
+            break;
+        }
+    }
+
+    // Com espera, nada é feito agora: o bot decide de novo antes da ação
+    const bot_plano_t *plano = &bot_planos[melhor];
+    if (plano->espera) {
+        bot->plano_fim = bot->tick;
+        bot->proxima_decisao = bot->tick + MIN((uint)plano->espera, BOT_ATENCAO);
+    } else {
+        bot->plano_entradas = plano->entradas;
+        bot->plano_fim = bot->tick + plano->ticks;
+        bot->proxima_decisao = bot->tick + MAX(1, MIN((uint)plano->ticks, BOT_ATENCAO));
+    }
+}
+
+// Entradas do tick atual; 'j' é o estado real antes do tick
+static uint8_t bot_entradas(bot_t *bot, const jogo_t *j, uint atraso_base) {
+    bot->vistos[bot->tick % BOT_MAX_ATRASO] = *j;
+
+    uint atraso = atraso_base + (config.jitter_ms ? rng_below(&bot->rng, config.jitter_ms + 1) : 0) *
+                                    1000 / FISICA_PASSO_US;
+    atraso = MIN(MIN(atraso, BOT_MAX_ATRASO - 1), bot->tick);
+
+    const jogo_t *visto = &bot->vistos[(bot->tick - atraso) % BOT_MAX_ATRASO];
+    if (bot->tick >= bot->proxima_decisao || visto->inimigos.gerados != bot->gerados_vistos) {
+        bot_decide(bot, atraso);
+    }
+
+    uint8_t entradas = bot->tick < bot->plano_fim ? bot->plano_entradas : 0;
+    bot->entradas[bot->tick % BOT_MAX_ATRASO] = entradas;
+    bot->tick++;
+    return entradas;
+}
+
+// Uma partida completa
+static autoplay_resultado_t autoplay_partida(const fisica_curva_t *curva, uint32_t semente, bot_t *bot) {
+    jogo_t jogo;
+    jogo_init(&jogo, config.dificuldade, curva, semente);
+
+    memset(bot, 0, offsetof(bot_t, rng));
+    rng_seed(&bot->rng, semente ^ 0xB07B07u);
+    uint atraso = config.reacao_ms * 1000 / FISICA_PASSO_US;
+
+    uint32_t ticks = 0;
+    while (!jogo.colidiu && ticks < config.max_ticks) {
+        jogo_passo(&jogo, bot_entradas(bot, &jogo, atraso));
+        ticks++;
+    }
+    return (autoplay_resultado_t){ticks, jogo.desviados};
+}
+
+//------------------------------------------------------------------------------
+// Pool com roubo de trabalho
+//------------------------------------------------------------------------------
+// Cada thread começa com uma faixa contínua de tarefas (partidas), guardada
+// como [início, fim) numa palavra atômica de 64 bits. O dono tira tarefas do
+// início; uma thread sem trabalho rouba a metade final da faixa de outra. As
+// duas operações são um compare-and-swap na faixa, sem locks.
+//------------------------------------------------------------------------------
+
+typedef struct {
+    _Atomic uint64_t faixa;
+    uint64_t roubos;
+    pthread_t thread;
+} autoplay_worker_t;
+
+static autoplay_worker_t workers[AUTOPLAY_MAX_THREADS];
+static uint n_workers;
+
+static inline uint64_t faixa_empacota(uint32_t inicio, uint32_t fim) {
+    return (uint64_t)fim << 32 | inicio;
+}
+
+// Tira a próxima tarefa da própria faixa
+static bool pool_pega(autoplay_worker_t *w, uint32_t *tarefa) {
+    uint64_t faixa = atomic_load(&w->faixa);
+    for (;;) {
+        uint32_t inicio = (uint32_t)faixa, fim = (uint32_t)(faixa >> 32);
+        if (inicio >= fim) {
+            return false;
+        }
+        if (atomic_compare_exchange_weak(&w->faixa, &faixa, faixa_empacota(inicio + 1, fim))) {
+            *tarefa = inicio;
+            return true;
+        }
+    }
+}
+
+// Rouba a metade final da faixa de outra thread (começando pela seguinte)
+static bool pool_rouba(autoplay_worker_t *w) {
+    uint eu = (uint)(w - workers);
+    for (uint k = 1; k < n_workers; k++) {
+        autoplay_worker_t *vitima = &workers[(eu + k) % n_workers];
+        uint64_t faixa = atomic_load(&vitima->faixa);
+        for (;;) {
+            uint32_t inicio = (uint32_t)faixa, fim = (uint32_t)(faixa >> 32);
+            if (inicio + 1 >= fim) {
+                break;
+            }
+            uint32_t meio = inicio + (fim - inicio) / 2;
+            if (atomic_compare_exchange_weak(&vitima->faixa, &faixa, faixa_empacota(inicio, meio))) {
+                atomic_store(&w->faixa, faixa_empacota(meio, fim));
+                w->roubos++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static void *pool_worker(void *arg) {
+    autoplay_worker_t *w = arg;
+    bot_t *bot = malloc(sizeof(*bot));
+    if (!bot) {
+        fprintf(stderr, "dino_autoplay: sem memória para o bot de uma thread\n");
+        exit(1);
+    }
+    uint32_t tarefa;
+    while (pool_pega(w, &tarefa) || (pool_rouba(w) && pool_pega(w, &tarefa))) {
+        uint conjunto = tarefa / runs;
+        uint32_t partida = tarefa % runs;
+        resultados[tarefa] = autoplay_partida(&conjuntos[conjunto], config.semente + partida, bot);
+    }
+    free(bot);
+    return NULL;
+}
+
+//------------------------------------------------------------------------------
+// Saída
+//------------------------------------------------------------------------------
+
+static int autoplay_compara_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint32_t percentil(const uint32_t *ordenados, uint32_t n, uint p) {
+    return ordenados[(uint64_t)(n - 1) * p / 100];
+}
+
+static void autoplay_relatorio(void) {
+    uint32_t *ticks = malloc(runs * sizeof(*ticks));
+    uint32_t *pontos = malloc(runs * sizeof(*pontos));
+    if (!ticks || !pontos) {
+        fprintf(stderr, "dino_autoplay: sem memória para o relatório de %lu partidas\n", (unsigned long)runs);
+        exit(1);
+    }
+    double segundos_por_tick = FISICA_PASSO_US / 1e6;
+
+    printf("# inicial_ms minimo_ms reducao_ms intervalo_s | sobrevida_s: media p10 p50 p90 | "
+           "placar: media p10 p50 p90 | ate_o_limite_%%\n");
+    for (uint c = 0; c < n_conjuntos; c++) {
+        double soma_ticks = 0, soma_pontos = 0;
+        uint32_t no_limite = 0;
+        for (uint32_t i = 0; i < runs; i++) {
+            const autoplay_resultado_t *r = &resultados[(size_t)c * runs + i];
+            ticks[i] = r->ticks;
+            pontos[i] = r->desviados;
+            soma_ticks += r->ticks;
+            soma_pontos += r->desviados;
+            no_limite += r->ticks >= config.max_ticks;
+        }
+        qsort(ticks, runs, sizeof(*ticks), autoplay_compara_u32);
+        qsort(pontos, runs, sizeof(*pontos), autoplay_compara_u32);
+
+        const fisica_curva_t *curva = &conjuntos[c];
+        printf("%u %u %u %u | %.2f %.2f %.2f %.2f | %.1f %u %u %u | %.1f\n", curva->inicial_us / 1000,
+               curva->minimo_us / 1000, curva->reducao_us / 1000, curva->intervalo_ms / 1000,
+               soma_ticks / runs * segundos_por_tick, percentil(ticks, runs, 10) * segundos_por_tick,
+               percentil(ticks, runs, 50) * segundos_por_tick, percentil(ticks, runs, 90) * segundos_por_tick,
+               soma_pontos / runs, percentil(pontos, runs, 10), percentil(pontos, runs, 50),
+               percentil(pontos, runs, 90), 100.0 * no_limite / runs);
+    }
+    free(ticks);
+    free(pontos);
+}
+
+//------------------------------------------------------------------------------
+// Linha de comando
+//------------------------------------------------------------------------------
+
+// Lista de inteiros separados por vírgula. Retorna a quantidade (0 se inválida)
+static uint autoplay_lista(const char *texto, uint32_t *valores) {
+    uint n = 0;
+    char *fim;
+    while (n < AUTOPLAY_MAX_VALORES) {
+        long v = strtol(texto, &fim, 10);
+        if (fim == texto || v <= 0) {
+            return 0;
+        }
+        valores[n++] = (uint32_t)v;
+        if (*fim != ',') {
+            break;
+        }
+        texto = fim + 1;
+    }
+    return *fim ? 0 : n;
+}
+
+static double autoplay_agora_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+    uint32_t inicial[AUTOPLAY_MAX_VALORES] = {jogo_curva_padrao.inicial_us / 1000};
+    uint32_t minimo[AUTOPLAY_MAX_VALORES] = {jogo_curva_padrao.minimo_us / 1000};
+    uint32_t reducao[AUTOPLAY_MAX_VALORES] = {jogo_curva_padrao.reducao_us / 1000};
+    uint32_t intervalo[AUTOPLAY_MAX_VALORES] = {jogo_curva_padrao.intervalo_ms / 1000};
+    uint n_inicial = 1, n_minimo = 1, n_reducao = 1, n_intervalo = 1;
+    bot_init_planos();
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    bool ok = true;
+
+    for (int i = 1; i < argc && ok; i++) {
+        const char *valor = i + 1 < argc ? argv[i + 1] : NULL;
+        ok = valor != NULL;
+        if (!ok) {
+            break;
+        }
+        if (strcmp(argv[i], "--runs") == 0) {
+            runs = (uint32_t)atol(valor);
+            ok = runs > 0;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            threads = atol(valor);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            config.semente = (uint32_t)strtoul(valor, NULL, 0);
+        } else if (strcmp(argv[i], "--dificuldade") == 0) {
+            config.dificuldade = (uint)atoi(valor);
+            ok = config.dificuldade < JOGO_DIFICULDADES;
+        } else if (strcmp(argv[i], "--reacao") == 0) {
+            config.reacao_ms = (uint)atoi(valor);
+        } else if (strcmp(argv[i], "--jitter") == 0) {
+            config.jitter_ms = (uint)atoi(valor);
+        } else if (strcmp(argv[i], "--max-s") == 0) {
+            config.max_ticks = (uint32_t)(atol(valor) * 1000000 / FISICA_PASSO_US);
+            ok = config.max_ticks > 0;
+        } else if (strcmp(argv[i], "--inicial") == 0) {
+            ok = (n_inicial = autoplay_lista(valor, inicial)) > 0;
+        } else if (strcmp(argv[i], "--minimo") == 0) {
+            ok = (n_minimo = autoplay_lista(valor, minimo)) > 0;
+        } else if (strcmp(argv[i], "--reducao") == 0) {
+            ok = (n_reducao = autoplay_lista(valor, reducao)) > 0;
+        } else if (strcmp(argv[i], "--intervalo") == 0) {
+            ok = (n_intervalo = autoplay_lista(valor, intervalo)) > 0;
+        } else {
+            ok = false;
+        }
+        i++;
+    }
+    if (!ok) {
+        fprintf(stderr,
+                "uso: %s [--runs n] [--threads n] [--seed n] [--dificuldade 0|1]\n"
+                "       [--reacao ms] [--jitter ms] [--max-s s]\n"
+                "       [--inicial ms,...] [--minimo ms,...] [--reducao ms,...] [--intervalo s,...]\n",
+                argv[0]);
+        return 2;
+    }
+    if ((config.reacao_ms + config.jitter_ms) * 1000 / FISICA_PASSO_US >= BOT_MAX_ATRASO) {
+        fprintf(stderr, "dino_autoplay: reação + jitter acima de %u ms\n",
+                (BOT_MAX_ATRASO - 1) * FISICA_PASSO_US / 1000);
+        return 2;
+    }
+
+    for (uint a = 0; a < n_inicial; a++) {
+        for (uint b = 0; b < n_minimo; b++) {
+            for (uint c = 0; c < n_reducao; c++) {
+                for (uint d = 0; d < n_intervalo; d++) {
+                    if (minimo[b] > inicial[a]) {
+                        continue;
+                    }
+                    conjuntos[n_conjuntos++] = (fisica_curva_t){
+                        .inicial_us = inicial[a] * 1000,
+                        .minimo_us = minimo[b] * 1000,
+                        .reducao_us = reducao[c] * 1000,
+                        .intervalo_ms = intervalo[d] * 1000};
+                }
+            }
+        }
+    }
+    uint64_t tarefas = (uint64_t)n_conjuntos * runs;
+    if (!n_conjuntos || tarefas > UINT32_MAX) {
+        fprintf(stderr, "dino_autoplay: nenhum conjunto válido ou partidas demais\n");
+        return 2;
+    }
+    resultados = calloc(tarefas, sizeof(*resultados));
+    if (!resultados) {
+        fprintf(stderr, "dino_autoplay: sem memória para %llu resultados\n", (unsigned long long)tarefas);
+        return 1;
+    }
+
+    // Faixas iniciais iguais; o roubo equilibra as partidas mais longas
+    n_workers = (uint)MAX(1, MIN(threads, AUTOPLAY_MAX_THREADS));
+    double inicio = autoplay_agora_s();
+    for (uint w = 0; w < n_workers; w++) {
+        uint32_t de = (uint32_t)(tarefas * w / n_workers);
+        uint32_t ate = (uint32_t)(tarefas * (w + 1) / n_workers);
+        atomic_init(&workers[w].faixa, faixa_empacota(de, ate));
+    }
+    for (uint w = 0; w < n_workers; w++) {
+        pthread_create(&workers[w].thread, NULL, pool_worker, &workers[w]);
+    }
+    uint64_t roubos = 0;
+    for (uint w = 0; w < n_workers; w++) {
+        pthread_join(workers[w].thread, NULL);
+        roubos += workers[w].roubos;
+    }
+    double duracao = autoplay_agora_s() - inicio;
+
+    autoplay_relatorio();
+    fprintf(stderr, "dino_autoplay: %llu partidas em %.2f s (%.0f/s), %u threads, %llu roubos\n",
+            (unsigned long long)tarefas, duracao, tarefas / duracao, n_workers, (unsigned long long)roubos);
+    free(resultados);
+    return 0;
+}
@@ -0,0 +1,416 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "hal.h"
+#include "ssd1306.h"
+#include "sprite.h"
+#include "tick.h"
+#include "obstaculos.h"
+#include "fisica.h"
+#include "anim.h"
+#include "np_lanes.h"
+
+//------------------------------------------------------------------------------
+// Benchmark nativo do Dino Runner (só no build host)
+//------------------------------------------------------------------------------
+// Roda a lógica do jogo (dino_runner.c, com main renomeada) sobre o backend
+// host da HAL, cujos LEDs, display e botões são apenas gravados em memória, e
+// mede separadamente os caminhos quentes da renderização. Cada medição é
+// calibrada para durar pelo menos BENCH_MIN_NS e repetida; o resultado é a
+// mediana, com o desvio absoluto mediano (MAD) como dispersão.
+//
+// Saída (stdout), uma linha por métrica: "<nome> <mediana> <mad> <unidade>".
+// Unidades terminadas em "/s" são vazões (maior é melhor); as demais são custos
+// (menor é melhor). Com --baseline, compara com um arquivo no mesmo formato e
+// termina com código 1 se alguma métrica piorar além da tolerância.
+//
+//   dino_runner_bench > baseline.txt
+//   dino_runner_bench --baseline baseline.txt [--tolerance 10] [--reps 11]
+//------------------------------------------------------------------------------
+
+#define BENCH_MIN_NS 20000000ull
+#define BENCH_MAX_REPS 64
+#define BENCH_MAX_RESULTS 32
+
+// Símbolos de dino_runner.c (incluído por dino_bench_game.c)
+int dino_runner_main(void);
+void setLeds(const sprite_t *camadas, int n);
+
+typedef struct {
+    const char *name;
+    const char *unit;
+    double median;
+    double mad;
+} bench_result_t;
+
+static bench_result_t results[BENCH_MAX_RESULTS];
+static size_t result_count;
+static uint reps = 11;
+
+// Evita que o compilador descarte os cálculos medidos
+static volatile uint32_t sink;
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_compare_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double bench_median(double *values, size_t count) {
+    qsort(values, count, sizeof(*values), bench_compare_double);
+    return count % 2 ? values[count / 2] : (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+static bool bench_is_rate(const char *unit) {
+    size_t length = strlen(unit);
+    return length >= 2 && strcmp(unit + length - 2, "/s") == 0;
+}
+
+static void bench_record(const char *name, const char *unit, double median, double mad) {
+    if (result_count < BENCH_MAX_RESULTS) {
+        results[result_count++] = (bench_result_t){name, unit, median, mad};
+    }
+    printf("%s %.6g %.6g %s\n", name, median, mad, unit);
+    fflush(stdout);
+}
+
+// Mede 'fn', que executa 'iterations' repetições e retorna a quantidade de
+// unidades de trabalho feitas (operações, ticks...). Para unidades "/s" o
+// resultado é unidades por segundo; senão, nanossegundos por unidade
+static void bench_run(const char *name, const char *unit, double (*fn)(uint64_t iterations)) {
+    // Calibração: dobra as repetições até uma medição passar de BENCH_MIN_NS
+    uint64_t iterations = 1;
+    for (;;) {
+        uint64_t start = bench_now_ns();
+        fn(iterations);
+        if (bench_now_ns() - start >= BENCH_MIN_NS || iterations >= (1ull << 40)) {
+            break;
+        }
+        iterations *= 2;
+    }
+
+    double values[BENCH_MAX_REPS];
+    for (uint r = 0; r < reps; r++) {
+        uint64_t start = bench_now_ns();
+        double work = fn(iterations);
+        double ns = (double)(bench_now_ns() - start);
+        values[r] = bench_is_rate(unit) ? work * 1e9 / ns : ns / work;
+    }
+
+    double median = bench_median(values, reps);
+    double deviations[BENCH_MAX_REPS];
+    for (uint r = 0; r < reps; r++) {
+        deviations[r] = values[r] > median ? values[r] - median : median - values[r];
+    }
+    bench_record(name, unit, median, bench_median(deviations, reps));
+}
+
+// Roda uma partida completa do jogo sobre o backend host, com o stdout do jogo
+// descartado. Retorna a quantidade de ticks lógicos simulados
+static uint32_t bench_play_game(void) {
+    static int null_fd = -1;
+    if (null_fd < 0) {
+        null_fd = open("/dev/null", O_WRONLY);
+    }
+
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    dup2(null_fd, STDOUT_FILENO);
+
+    hal_host_reset();
+    dino_runner_main();
+
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    return tick_stats()->ticks;
+}
+
+static double bench_game(uint64_t iterations) {
+    double ticks = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        ticks += bench_play_game();
+    }
+    return ticks;
+}
+
+// Camadas variadas, para que a composição e a colisão não sejam constantes
+static sprite_t bench_layers[32][2];
+
+static void bench_init_layers(void) {
+    srand(1);
+    for (uint i = 0; i < count_of(bench_layers); i++) {
+        bench_layers[i][0] = (sprite_t){.mask = (sprite_mask_t)rand() & ((1u << SPRITE_PIXELS) - 1), .paleta = 1};
+        bench_layers[i][1] = (sprite_t){.mask = SPRITE_BIT(rand() % SPRITE_LINHAS, rand() % SPRITE_COLUNAS), .paleta = 2};
+    }
+}
+
+static double bench_compose(uint64_t iterations) {
+    for (uint64_t i = 0; i < iterations; i++) {
+        setLeds(bench_layers[i % count_of(bench_layers)], 2);
+    }
+    return (double)iterations;
+}
+
+static double bench_collide(uint64_t iterations) {
+    uint32_t hits = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        const sprite_t *layers = bench_layers[i % count_of(bench_layers)];
+        hits += sprite_colide(layers[0].mask, layers[1].mask);
+    }
+    sink = hits;
+    return (double)iterations;
+}
+
+static uint8_t bench_oled[ssd1306_buffer_length];
+
+static double bench_draw_string(uint64_t iterations) {
+    char text[] = "  Desviados: 123";
+    for (uint64_t i = 0; i < iterations; i++) {
+        text[13] = (char)('0' + i % 10);
+        ssd1306_draw_string(bench_oled, 5, (int16_t)(i % 7) * 8, text);
+    }
+    sink = bench_oled[0];
+    return (double)iterations;
+}
+
+static double bench_set_pixel(uint64_t iterations) {
+    for (uint64_t i = 0; i < iterations; i++) {
+        uint32_t n = (uint32_t)i * 2654435761u;
+        ssd1306_set_pixel(bench_oled, n % ssd1306_width, (n >> 8) % ssd1306_height, n & 0x10000);
+    }
+    sink = bench_oled[0];
+    return (double)iterations;
+}
+
+static double bench_draw_line(uint64_t iterations) {
+    for (uint64_t i = 0; i < iterations; i++) {
+        uint32_t n = (uint32_t)i * 2654435761u;
+        ssd1306_draw_line(bench_oled, n % ssd1306_width, (n >> 7) % ssd1306_height,
+                          (n >> 13) % ssd1306_width, (n >> 20) % ssd1306_height, true);
+    }
+    sink = bench_oled[0];
+    return (double)iterations;
+}
+
+// Sprite 16x16 em posições quaisquer (inclusive fora do alinhamento de página
+// e parcialmente fora da tela)
+static double bench_blit(uint64_t iterations) {
+    static const uint8_t sprite[32] = {
+        0x00, 0xE0, 0xF0, 0xF8, 0xF8, 0xF8, 0xF0, 0xE0, 0xC0, 0xC0, 0xE0, 0xF0, 0x78, 0x3C, 0x1C, 0x00,
+        0x00, 0x07, 0x0F, 0x1F, 0x3F, 0xFF, 0x7F, 0x3F, 0x1F, 0x3F, 0x7F, 0x0F, 0x03, 0x00, 0x00, 0x00,
+    };
+    for (uint64_t i = 0; i < iterations; i++) {
+        uint32_t n = (uint32_t)i * 2654435761u;
+        ssd1306_blit(bench_oled, (int)(n % 136) - 8, (int)((n >> 8) % 72) - 8, sprite, 16, 16,
+                     (ssd1306_rop_t)(i & 3));
+    }
+    sink = bench_oled[0];
+    return (double)iterations;
+}
+
+static double bench_fill_rect(uint64_t iterations) {
+    for (uint64_t i = 0; i < iterations; i++) {
+        uint32_t n = (uint32_t)i * 2654435761u;
+        ssd1306_fill_rect(bench_oled, n % ssd1306_width, (n >> 7) % ssd1306_height, (n >> 13) % 64,
+                          (n >> 19) % 32, n & 1, (ssd1306_rop_t)((n >> 1) & 3));
+    }
+    sink = bench_oled[0];
+    return (double)iterations;
+}
+
+// Pool cheio: a cada passo de 10 ms entram 4 obstáculos, que andam uma coluna
+// por passo e ficam ~8 passos no pool (começam até 3 colunas fora da tela)
+static const obstaculo_padrao_t bench_patterns[] = {
+    {1, 1, 4, {{0, OBSTACULO_FAIXA_ALEATORIA, 0, 100}, {1, OBSTACULO_FAIXA_ALEATORIA, 1, 100},
+               {2, OBSTACULO_FAIXA_ALEATORIA, 0, 100}, {3, OBSTACULO_FAIXA_ALEATORIA, 1, 100}}},
+};
+
+static obstaculos_t bench_pool;
+
+static double bench_obstacles(uint64_t iterations) {
+    sprite_mask_t masks[OBSTACULOS_TIPOS];
+    uint32_t passed = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        passed += obstaculos_passo(&bench_pool, 10000, 10000, FX_UM, masks);
+    }
+    sink = passed + masks[0];
+    return (double)iterations;
+}
+
+// Subpasso da física do dino, pulando sem parar (o botão alterna a cada 64
+// subpassos entre mantido e solto)
+static double bench_physics(uint64_t iterations) {
+    fisica_dino_t dino;
+    fisica_dino_init(&dino);
+    for (uint64_t i = 0; i < iterations; i++) {
+        fisica_dino_passo(&dino, i & 64, (i & 511) == 511);
+    }
+    sink = (uint32_t)dino.altura + dino.pulos;
+    return (double)iterations;
+}
+
+// Animação de 32 frames (128x64): um quadrado de 16x16 atravessa a tela sobre
+// um fundo fixo, como numa tela de título
+#define BENCH_ANIM_FRAMES 32
+#define BENCH_ANIM_BYTES (ssd1306_width * ssd1306_n_pages)
+static uint8_t bench_anim[ANIM_HEADER_BYTES + BENCH_ANIM_FRAMES * ANIM_FRAME_MAX(BENCH_ANIM_BYTES)];
+static size_t bench_anim_length;
+static ssd1306_t bench_anim_display = {.width = ssd1306_width, .pages = ssd1306_n_pages};
+static anim_player_t bench_anim_player;
+
+static void bench_init_anim(void) {
+    static uint8_t prev[BENCH_ANIM_BYTES], cur[BENCH_ANIM_BYTES];
+    bench_anim_length = anim_encode_header(bench_anim, ssd1306_width, ssd1306_n_pages, BENCH_ANIM_FRAMES, 33);
+    for (int f = 0; f < BENCH_ANIM_FRAMES; f++) {
+        // Ordem do framebuffer: 'width' bytes por página
+        for (int page = 0; page < ssd1306_n_pages; page++) {
+            for (int col = 0; col < ssd1306_width; col++) {
+                bool square = col >= f * 4 && col < f * 4 + 16 && (page == 3 || page == 4);
+                cur[page * ssd1306_width + col] = square ? 0xFF : page == ssd1306_n_pages - 1 ? 0x01 : 0x00;
+            }
+        }
+        bench_anim_length += anim_encode_frame(prev, cur, BENCH_ANIM_BYTES, bench_anim + bench_anim_length,
+                                               sizeof(bench_anim) - bench_anim_length);
+        memcpy(prev, cur, sizeof(prev));
+    }
+    anim_start(&bench_anim_player, &bench_anim_display, bench_anim, bench_anim_length, false);
+}
+
+// Decodificação de um frame da animação (sem o envio)
+static double bench_anim_decode(uint64_t iterations) {
+    static uint8_t buffer[BENCH_ANIM_BYTES];
+    int first, last;
+    for (uint64_t i = 0; i < iterations; i++) {
+        if (!anim_decode_frame(&bench_anim_player, buffer, &first, &last)) {
+            anim_start(&bench_anim_player, &bench_anim_display, bench_anim, bench_anim_length, false);
+            anim_decode_frame(&bench_anim_player, buffer, &first, &last);
+        }
+    }
+    sink = buffer[0] + first + last;
+    return (double)iterations;
+}
+
+// Transposição da saída paralela: 8 fitas de BENCH_LANE_LEDS LEDs, custo por
+// LED de fita (os 8 LEDs que saem juntos)
+#define BENCH_LANE_LEDS 256
+
+static double bench_lanes_transpose(uint64_t iterations) {
+    static uint32_t grb[8 * BENCH_LANE_LEDS];
+    static uint32_t words[NP_LANES_WORDS(BENCH_LANE_LEDS)];
+    for (uint i = 0; i < 8 * BENCH_LANE_LEDS; i++) {
+        grb[i] = (i * 2654435761u) & 0xFFFFFF00u;
+    }
+    for (uint64_t i = 0; i < iterations; i++) {
+        np_lanes_transpose(grb, BENCH_LANE_LEDS, 8, words);
+        grb[i % (8 * BENCH_LANE_LEDS)] ^= words[i % NP_LANES_WORDS(BENCH_LANE_LEDS)] & 0xFFFFFF00u;
+    }
+    sink = words[0];
+    return (double)iterations * BENCH_LANE_LEDS;
+}
+
+// Bytes que iriam para os periféricos por frame de LED, em uma partida
+static void bench_bytes_per_frame(void) {
+    uint32_t ticks = bench_play_game();
+    uint64_t frames = hal_host_led_frame_count();
+    const hal_host_led_frame_t *led = hal_host_led_frame(0);
+    hal_host_i2c_stats_t i2c = hal_host_i2c_stats(HAL_I2C1);
+
+    bench_record("game_ticks", "ticks", ticks, 0);
+    bench_record("i2c_bytes_per_frame", "bytes", frames ? (double)i2c.bytes / frames : 0, 0);
+    bench_record("i2c_transactions_per_frame", "transactions", frames ? (double)i2c.transactions / frames : 0, 0);
+    bench_record("pio_bytes_per_frame", "bytes", led ? (double)led->length : 0, 0);
+}
+
+// Compara os resultados com o arquivo de referência. Retorna quantas métricas
+// pioraram além da tolerância (em %)
+static int bench_compare(const char *path, double tolerance) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "dino_runner_bench: não foi possível abrir %s\n", path);
+        return 1;
+    }
+
+    int regressions = 0;
+    char line[256], name[64], unit[32];
+    double median, mad;
+    while (fgets(line, sizeof(line), file)) {
+        if (sscanf(line, "%63s %lf %lf %31s", name, &median, &mad, unit) != 4) {
+            continue;
+        }
+        for (size_t i = 0; i < result_count; i++) {
+            if (strcmp(results[i].name, name) != 0) {
+                continue;
+            }
+            // Só conta como regressão o que passa da tolerância e também do
+            // ruído das duas medições (3x a soma dos MADs)
+            double change = median ? (results[i].median - median) / median * 100 : 0;
+            double diff = results[i].median - median;
+            bool noisy = (diff < 0 ? -diff : diff) <= 3 * (mad + results[i].mad);
+            bool worse = !noisy && (bench_is_rate(unit) ? change < -tolerance : change > tolerance);
+            fprintf(stderr, "%-28s %12.6g -> %12.6g %s (%+.1f%%)%s\n", name, median,
+                    results[i].median, unit, change, worse ? "  REGRESSÃO" : "");
+            regressions += worse;
+        }
+    }
+    fclose(file);
+    return regressions;
+}
+
+int main(int argc, char **argv) {
+    const char *baseline = NULL;
+    double tolerance = 10;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baseline = argv[++i];
+        } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            reps = (uint)atoi(argv[++i]);
+            reps = reps < 1 ? 1 : reps > BENCH_MAX_REPS ? BENCH_MAX_REPS : reps;
+        } else {
+            fprintf(stderr, "uso: %s [--baseline arquivo] [--tolerance %%] [--reps n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Sem roteiro de entradas nem dump: as partidas são todas iguais
+    unsetenv("DINO_HOST_INPUT");
+    unsetenv("DINO_HOST_DUMP");
+    unsetenv("DINO_HOST_MAX_MS");
+    hal_init();
+    bench_init_layers();
+
+    bench_bytes_per_frame();
+    bench_run("game_ticks_per_s", "ticks/s", bench_game);
+    bench_run("compose_ns", "ns", bench_compose);
+    bench_run("collide_ns", "ns", bench_collide);
+    obstaculos_init(&bench_pool, bench_patterns, count_of(bench_patterns), SPRITE_COLUNAS - 1, 0, SPRITE_LINHAS - 1, 1);
+    bench_run("obstacles_step_ns", "ns", bench_obstacles);
+    bench_record("obstacles_live", "obstacles", bench_pool.n, 0);
+    bench_run("physics_substep_ns", "ns", bench_physics);
+    bench_run("draw_string_ns", "ns", bench_draw_string);
+    bench_run("set_pixel_ns", "ns", bench_set_pixel);
+    bench_run("draw_line_ns", "ns", bench_draw_line);
+    bench_run("blit_ns", "ns", bench_blit);
+    bench_run("fill_rect_ns", "ns", bench_fill_rect);
+    bench_init_anim();
+    bench_record("anim_stream_bytes_per_frame", "bytes", (double)(bench_anim_length - ANIM_HEADER_BYTES) / BENCH_ANIM_FRAMES, 0);
+    bench_run("anim_decode_ns", "ns", bench_anim_decode);
+    bench_run("lanes_transpose_ns", "ns", bench_lanes_transpose);
+
+    if (baseline && bench_compare(baseline, tolerance)) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,3 @@
+// O jogo completo, com main renomeada para ser chamado pelo benchmark
+#define main dino_runner_main
+#include "dino_runner.c"
@@ -0,0 +1,272 @@
+#!/usr/bin/env python3
+# ------------------------------------------------------------------------------
+# Orçamento de memória do Dino Runner (passo do build da placa)
+# ------------------------------------------------------------------------------
+# Lê o ELF final (com o nm da toolchain) e os arquivos .su/.ci gerados pelo GCC
+# com -fstack-usage -fcallgraph-info=su, e escreve um relatório com:
+#   - flash e RAM estática usadas, com os maiores símbolos de cada uma e o
+#     código que roda da SRAM (__not_in_flash_func);
+#   - a maior profundidade de pilha a partir da raiz de cada núcleo, mais a
+#     maior das interrupções que podem chegar nele, com o caminho.
+# Termina com código 1 se algum limite for ultrapassado, o que falha o build.
+#
+# Chamadas por ponteiro não aparecem no grafo do GCC: --indireto liga o
+# chamador aos alvos conhecidos. Se o chamador foi expandido inline em outra
+# função, os alvos valem para todas as chamadas por ponteiro sem alvo (uma
+# estimativa por cima). As que sobram, as funções sem informação de pilha
+# (libc, libgcc, ROM) e as recursões entram no relatório como avisos e contam
+# 0 bytes.
+#
+#   dino_orcamento.py --elf dino_runner.elf --nm arm-none-eabi-nm
+#       --objetos CMakeFiles/dino_runner.dir --flash 0x10000000:2080768
+#       --ram 0x20000000:196608 --pilha nucleo0:2048:main:hal_gpio_irq
+#       --indireto hal_core1_main=core1_main --saida dino_runner.orcamento.txt
+# ------------------------------------------------------------------------------
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+# Símbolos do linker do SDK que marcam o fim de cada região
+FIM_FLASH = '__flash_binary_end'
+FIM_RAM = '__bss_end__'
+
+NO = re.compile(r'node: \{ title: "([^"]+)" label: "([^"]*)"')
+ARESTA = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+PILHA = re.compile(r'\\n(\d+) bytes \(([\w,]+)')
+
+
+def numero(texto):
+    return int(texto, 0)
+
+
+def regiao(texto):
+    inicio, tamanho = texto.split(':')
+    return numero(inicio), numero(tamanho)
+
+
+# ------------------------------------------------------------------------------
+# Símbolos
+# ------------------------------------------------------------------------------
+
+def le_simbolos(nm, elf):
+    saida = subprocess.run([nm, '-S', '-t', 'x', elf], check=True, capture_output=True, text=True).stdout
+    simbolos = []
+    marcas = {}
+    for linha in saida.splitlines():
+        campos = linha.split()
+        if len(campos) == 4:
+            simbolos.append((campos[3], int(campos[0], 16), int(campos[1], 16), campos[2]))
+        elif len(campos) == 3:
+            marcas[campos[2]] = int(campos[0], 16)
+    return simbolos, marcas
+
+
+# Regiões do mapa de memória: o limite vale para o uso, mas um símbolo pertence
+# à região se estiver nos 256 MB a partir do início dela (flash em 0x10000000,
+# SRAM em 0x20000000 no RP2040)
+def dentro(endereco, regiao):
+    return regiao[0] <= endereco < regiao[0] + 0x10000000
+
+
+def orcamento_memoria(simbolos, marcas, flash, ram, top, relatorio):
+    na_flash = [s for s in simbolos if dentro(s[1], flash)]
+    na_ram = [s for s in simbolos if dentro(s[1], ram)]
+    codigo_ram = [s for s in na_ram if s[3] in 'Tt']
+
+    # Sem os símbolos do linker, o fim é o do último símbolo da região
+    fim_flash = marcas.get(FIM_FLASH, max((s[1] + s[2] for s in na_flash), default=flash[0]))
+    fim_ram = marcas.get(FIM_RAM, max((s[1] + s[2] for s in na_ram), default=ram[0]))
+    usado_flash = fim_flash - flash[0]
+    usado_ram = fim_ram - ram[0]
+
+    relatorio.append('flash: %d de %d bytes (%.1f%%)' % (usado_flash, flash[1], 100.0 * usado_flash / flash[1]))
+    relatorio.append('ram estática: %d de %d bytes (%.1f%%), %d em código na SRAM' %
+                     (usado_ram, ram[1], 100.0 * usado_ram / ram[1], sum(s[2] for s in codigo_ram)))
+
+    for titulo, lista in (('flash', na_flash), ('ram', na_ram)):
+        relatorio.append('')
+        relatorio.append('maiores símbolos (%s):' % titulo)
+        for nome, _, tamanho, tipo in sorted(lista, key=lambda s: -s[2])[:top]:
+            relatorio.append('  %8d %s %s' % (tamanho, tipo, nome))
+
+    relatorio.append('')
+    relatorio.append('código na SRAM:')
+    for nome, _, tamanho, _ in sorted(codigo_ram, key=lambda s: -s[2]):
+        relatorio.append('  %8d %s' % (tamanho, nome))
+
+    erros = []
+    if usado_flash > flash[1]:
+        erros.append('flash: %d bytes, limite %d' % (usado_flash, flash[1]))
+    if usado_ram > ram[1]:
+        erros.append('ram estática: %d bytes, limite %d' % (usado_ram, ram[1]))
+    return erros
+
+
+# ------------------------------------------------------------------------------
+# Pilha
+# ------------------------------------------------------------------------------
+
+class Grafo:
+    def __init__(self):
+        self.pilha = {}        # título -> bytes do quadro da função
+        self.dinamicas = set() # funções com alloca/VLA (tamanho não limitado)
+        self.chamadas = {}     # título -> alvos (títulos ou nomes externos)
+        self.por_nome = {}     # nome -> títulos definidos com esse nome
+
+    def le(self, pasta):
+        for raiz, _, arquivos in os.walk(pasta):
+            for arquivo in arquivos:
+                if arquivo.endswith('.ci'):
+                    with open(os.path.join(raiz, arquivo), errors='replace') as f:
+                        self.le_ci(f.read())
+
+    def le_ci(self, texto):
+        for titulo, rotulo in NO.findall(texto):
+            m = PILHA.search(rotulo)
+            if not m:
+                continue  # declaração externa
+            self.pilha[titulo] = int(m.group(1))
+            if m.group(2) == 'dynamic':  # 'dynamic,bounded' tem limite conhecido
+                self.dinamicas.add(titulo)
+            self.por_nome.setdefault(titulo.split(':')[-1], []).append(titulo)
+        for origem, destino in ARESTA.findall(texto):
+            self.chamadas.setdefault(origem, []).append(destino)
+
+    # Nome de função (de --indireto, --pilha ou de uma chamada externa) no
+    # título da definição: global primeiro, depois estática de nome único
+    def resolve(self, nome):
+        if nome in self.pilha:
+            return nome
+        titulos = self.por_nome.get(nome, [])
+        return titulos[0] if len(titulos) == 1 else None
+
+    def profundidade(self, raiz, avisos):
+        memo = {}
+        visitando = set()
+
+        def visita(titulo):
+            if titulo in memo:
+                return memo[titulo]
+            if titulo in visitando:
+                avisos.add('recursão em %s (contada uma vez)' % titulo)
+                return 0, []
+            visitando.add(titulo)
+            melhor, caminho = 0, []
+            for alvo in self.chamadas.get(titulo, []):
+                if alvo == '__indirect_call':
+                    avisos.add('chamada por ponteiro sem alvo em %s' % titulo)
+                    continue
+                resolvido = self.resolve(alvo)
+                if resolvido is None:
+                    avisos.add('sem informação de pilha: %s' % alvo)
+                    continue
+                total, sub = visita(resolvido)
+                if total > melhor:
+                    melhor, caminho = total, sub
+            if titulo in self.dinamicas:
+                avisos.add('pilha dinâmica em %s' % titulo)
+            visitando.discard(titulo)
+            memo[titulo] = (self.pilha[titulo] + melhor, [titulo] + caminho)
+            return memo[titulo]
+
+        return visita(raiz)
+
+
+def orcamento_pilhas(grafo, pilhas, irq_extra, relatorio, avisos):
+    erros = []
+    relatorio.append('')
+    for especificacao in pilhas:
+        nome, limite, raiz, *resto = especificacao.split(':')
+        limite = numero(limite)
+        irqs = resto[0].split(',') if resto and resto[0] else []
+
+        titulo = grafo.resolve(raiz)
+        if titulo is None:
+            avisos.add('raiz %s não encontrada no grafo' % raiz)
+            continue
+        total, caminho = grafo.profundidade(titulo, avisos)
+
+        # As interrupções têm a mesma prioridade e não se aninham: soma-se a
+        # maior delas, mais o quadro de exceção e o despacho do SDK
+        pior_irq, caminho_irq = 0, []
+        for irq in irqs:
+            titulo_irq = grafo.resolve(irq)
+            if titulo_irq is None:
+                avisos.add('interrupção %s não encontrada no grafo' % irq)
+                continue
+            profundidade, sub = grafo.profundidade(titulo_irq, avisos)
+            if profundidade > pior_irq:
+                pior_irq, caminho_irq = profundidade, sub
+        if irqs:
+            pior_irq += irq_extra
+        soma = total + pior_irq
+
+        relatorio.append('pilha %s: %d de %d bytes (%d na raiz + %d em interrupção)' % (nome, soma, limite, total, pior_irq))
+        relatorio.append('    ' + ' > '.join('%s (%d)' % (t.split(':')[-1], grafo.pilha[t]) for t in caminho))
+        if caminho_irq:
+            relatorio.append('    ' + ' > '.join('%s (%d)' % (t.split(':')[-1], grafo.pilha[t]) for t in caminho_irq))
+        if soma > limite:
+            erros.append('pilha %s: %d bytes, limite %d' % (nome, soma, limite))
+    return erros
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Orçamento de flash, RAM e pilha do Dino Runner')
+    parser.add_argument('--elf', required=True)
+    parser.add_argument('--nm', default='nm')
+    parser.add_argument('--objetos', required=True, help='pasta com os .ci do GCC')
+    parser.add_argument('--flash', type=regiao, required=True, help='início:limite')
+    parser.add_argument('--ram', type=regiao, required=True, help='início:limite')
+    parser.add_argument('--pilha', action='append', default=[], help='nome:limite:raiz[:irq,irq...]')
+    parser.add_argument('--indireto', action='append', default=[], help='chamador=alvo[,alvo...]')
+    parser.add_argument('--irq-extra', type=numero, default=0, help='bytes somados a cada interrupção')
+    parser.add_argument('--top', type=int, default=15)
+    parser.add_argument('--saida')
+    args = parser.parse_args()
+
+    relatorio = []
+    avisos = set()
+    simbolos, marcas = le_simbolos(args.nm, args.elf)
+    erros = orcamento_memoria(simbolos, marcas, args.flash, args.ram, args.top, relatorio)
+
+    grafo = Grafo()
+    grafo.le(args.objetos)
+    sem_chamador = []
+    for ligacao in args.indireto:
+        chamador, alvos = ligacao.split('=')
+        alvos = [grafo.resolve(alvo) or alvo for alvo in alvos.split(',')]
+        titulo = grafo.resolve(chamador)
+        if titulo is None:
+            avisos.add('chamador %s não encontrado (inline?): alvos somados a toda chamada por ponteiro' % chamador)
+            sem_chamador += alvos
+            continue
+        chamadas = [c for c in grafo.chamadas.get(titulo, []) if c != '__indirect_call']
+        grafo.chamadas[titulo] = chamadas + alvos
+    if sem_chamador:
+        for titulo, chamadas in grafo.chamadas.items():
+            if '__indirect_call' in chamadas:
+                grafo.chamadas[titulo] = [c for c in chamadas if c != '__indirect_call'] + sem_chamador
+    erros += orcamento_pilhas(grafo, args.pilha, args.irq_extra, relatorio, avisos)
+
+    if avisos:
+        relatorio.append('')
+        relatorio.append('avisos:')
+        relatorio += ['  ' + aviso for aviso in sorted(avisos)]
+    for erro in erros:
+        relatorio.append('LIMITE EXCEDIDO: ' + erro)
+
+    texto = '\n'.join(relatorio) + '\n'
+    if args.saida:
+        with open(args.saida, 'w') as f:
+            f.write(texto)
+    # No console, só o resumo; o relatório completo vai para --saida
+    resumo = [l for l in relatorio if l.startswith(('flash:', 'ram estática:', 'pilha ', 'LIMITE'))]
+    print('\n'.join('orcamento: ' + l for l in (resumo if args.saida else relatorio)))
+    return 1 if erros else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
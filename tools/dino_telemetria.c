@@ -0,0 +1,329 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hal.h"
+#include "jogo.h"
+#include "np_geometry.h"
+#include "telemetria.h"
+
+//------------------------------------------------------------------------------
+// Decodificador da telemetria (só no build host)
+//------------------------------------------------------------------------------
+// Lê o fluxo de bytes da serial da placa (compilada com -DDINO_TELEMETRIA=1)
+// ou uma captura dele, e mostra o jogo no terminal ou grava os pacotes em
+// texto:
+//
+//   stty -F /dev/ttyACM0 raw && dino_telemetria --tela /dev/ttyACM0
+//   cat /dev/ttyACM0 > sessao.bin                    (captura)
+//   dino_telemetria --tela --tempo-real sessao.bin   (revê no ritmo original)
+//   dino_telemetria --dump pacotes.txt sessao.bin
+//
+// O espelho dos LEDs usa a geometria de inc/np_geometry.h: compile com os
+// mesmos -DNP_* da placa. O texto do stdio que vem misturado aos pacotes vai
+// para o stderr (com --texto). O resumo (pacotes, quadros inválidos e pacotes
+// perdidos pela placa) sai no stderr no fim.
+//------------------------------------------------------------------------------
+
+#define TELEMETRIA_TOOL_PORTAS 2
+#define TELEMETRIA_TOOL_OLED_BYTES 1024
+#define TELEMETRIA_TOOL_LEDS 4096
+
+typedef struct {
+    FILE *dump;
+    bool tela;
+    bool tempo_real;
+    bool texto;
+    uint porta_tela;
+
+    telemetria_decodificador_t decodificador;
+
+    // Último estado, frame dos LEDs e conteúdo de cada display
+    telemetria_estado_t estado;
+    bool tem_estado;
+    uint8_t leds[TELEMETRIA_TOOL_LEDS * 3];
+    uint leds_largura, leds_altura;
+    uint8_t oled[TELEMETRIA_TOOL_PORTAS][TELEMETRIA_TOOL_OLED_BYTES];
+    bool tem_oled[TELEMETRIA_TOOL_PORTAS];
+
+    // Ritmo: instante do primeiro pacote na placa e no relógio local
+    bool ritmo_iniciado;
+    uint32_t ritmo_placa_us;
+    uint64_t ritmo_local_us;
+
+    // Vazão: bytes lidos e instantes do primeiro e do último pacote na placa
+    uint64_t bytes_lidos;
+    bool tem_tempo;
+    uint32_t primeiro_us, ultimo_us;
+} telemetria_tool_t;
+
+static uint16_t get_u16(const uint8_t *bytes) {
+    return bytes[0] | bytes[1] << 8;
+}
+
+static uint64_t relogio_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void dump_hex(FILE *file, const uint8_t *bytes, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        fprintf(file, "%02x", bytes[i]);
+    }
+}
+
+// Espera até o instante do pacote, contado a partir do primeiro
+static void espera_ritmo(telemetria_tool_t *tool, uint32_t tempo_us) {
+    if (!tool->ritmo_iniciado) {
+        tool->ritmo_iniciado = true;
+        tool->ritmo_placa_us = tempo_us;
+        tool->ritmo_local_us = relogio_us();
+        return;
+    }
+    uint64_t alvo = tool->ritmo_local_us + (uint32_t)(tempo_us - tool->ritmo_placa_us);
+    uint64_t agora = relogio_us();
+    if (alvo > agora) {
+        struct timespec ts = {(time_t)((alvo - agora) / 1000000), (long)((alvo - agora) % 1000000) * 1000};
+        nanosleep(&ts, NULL);
+    }
+}
+
+// Cor de um LED no terminal: os LEDs saem com pouco brilho, então os valores
+// acesos são levados para a faixa visível
+static uint cor_visivel(uint8_t valor) {
+    return valor ? 64 + valor * 191 / 255 : 0;
+}
+
+static void desenha_tela(telemetria_tool_t *tool) {
+    printf("\x1b[H");
+
+    // LEDs: na geometria da matriz se o frame tiver o mesmo tamanho, senão em fila
+    bool matriz = tool->leds_largura == NP_WIDTH && tool->leds_altura == NP_HEIGHT;
+    uint linhas = matriz ? NP_HEIGHT : 1;
+    uint colunas = matriz ? NP_WIDTH : MIN(tool->leds_largura * tool->leds_altura, 64u);
+    for (uint y = 0; y < linhas; y++) {
+        for (uint x = 0; x < colunas; x++) {
+            uint i = matriz ? (uint)NP_INDEX(x, y) : x;
+            const uint8_t *grb = tool->leds + i * 3;
+            printf("\x1b[48;2;%u;%u;%um  ", cor_visivel(grb[1]), cor_visivel(grb[0]), cor_visivel(grb[2]));
+        }
+        printf("\x1b[0m\x1b[K\n");
+    }
+
+    // OLED: dois pixels por caractere (meio bloco)
+    const uint8_t *oled = tool->oled[tool->porta_tela];
+    for (uint y = 0; y < 64; y += 2) {
+        for (uint x = 0; x < TELEMETRIA_OLED_LARGURA; x++) {
+            uint8_t byte = oled[(y / 8) * TELEMETRIA_OLED_LARGURA + x];
+            bool cima = byte & (1 << (y % 8));
+            bool baixo = byte & (1 << (y % 8 + 1));
+            fputs(cima ? (baixo ? "█" : "▀") : (baixo ? "▄" : " "), stdout);
+        }
+        printf("\x1b[K\n");
+    }
+
+    const telemetria_estado_t *e = &tool->estado;
+    printf("tick %lu  desviados %lu  altura %.2f  período %lu us  entradas %c%c%s\x1b[K\n",
+           (unsigned long)e->tick, (unsigned long)e->desviados, e->altura / 65536.0,
+           (unsigned long)e->periodo_us, e->entradas & ENTRADA_PULO ? 'P' : '-',
+           e->entradas & ENTRADA_ABAIXAR ? 'A' : '-', e->colidiu ? "  GAME OVER" : "");
+    printf("pacotes %lu  inválidos %lu  perdidos %lu\x1b[K\n", (unsigned long)tool->decodificador.pacotes,
+           (unsigned long)tool->decodificador.invalidos, (unsigned long)tool->decodificador.perdidos);
+    fflush(stdout);
+}
+
+static void recebe_estado(telemetria_tool_t *tool, const telemetria_pacote_t *pacote) {
+    if (!telemetria_le_estado(pacote, &tool->estado)) {
+        return;
+    }
+    tool->tem_estado = true;
+    const telemetria_estado_t *e = &tool->estado;
+    if (tool->dump) {
+        fprintf(tool->dump,
+                "estado %u %lu tick=%lu entradas=%u botoes=%u colidiu=%u desviados=%lu altura=%ld periodo=%lu "
+                "dino=%08lx inimigos=",
+                pacote->sequencia, (unsigned long)pacote->tempo_us, (unsigned long)e->tick, e->entradas,
+                e->botoes, e->colidiu, (unsigned long)e->desviados, (long)e->altura,
+                (unsigned long)e->periodo_us, (unsigned long)e->dino);
+        for (uint tipo = 0; tipo < OBSTACULOS_TIPOS; tipo++) {
+            fprintf(tool->dump, "%s%08lx", tipo ? "," : "", (unsigned long)e->inimigos[tipo]);
+        }
+        fputc('\n', tool->dump);
+    }
+    // A tela é redesenhada uma vez por tick
+    if (tool->tela) {
+        if (tool->tempo_real) {
+            espera_ritmo(tool, pacote->tempo_us);
+        }
+        desenha_tela(tool);
+    }
+}
+
+static void recebe_leds(telemetria_tool_t *tool, const telemetria_pacote_t *pacote) {
+    if (pacote->tamanho < 8) {
+        return;
+    }
+    uint largura = get_u16(pacote->dados);
+    uint altura = get_u16(pacote->dados + 2);
+    uint primeiro = get_u16(pacote->dados + 4);
+    uint n = get_u16(pacote->dados + 6);
+    if (pacote->tamanho != 8 + n * 3 || primeiro + n > TELEMETRIA_TOOL_LEDS) {
+        return;
+    }
+    tool->leds_largura = largura;
+    tool->leds_altura = altura;
+    memcpy(tool->leds + primeiro * 3, pacote->dados + 8, n * 3);
+    if (tool->dump) {
+        fprintf(tool->dump, "leds %u %lu %ux%u %u ", pacote->sequencia, (unsigned long)pacote->tempo_us, largura,
+                altura, primeiro);
+        dump_hex(tool->dump, pacote->dados + 8, n * 3);
+        fputc('\n', tool->dump);
+    }
+}
+
+static void recebe_oled(telemetria_tool_t *tool, const telemetria_pacote_t *pacote) {
+    if (pacote->tamanho < 5) {
+        return;
+    }
+    const uint8_t *d = pacote->dados;
+    uint porta = d[0], c0 = d[1], c1 = d[2], p0 = d[3], p1 = d[4];
+    uint largura = c1 - c0 + 1;
+    if (porta >= TELEMETRIA_TOOL_PORTAS || c0 > c1 || c1 >= TELEMETRIA_OLED_LARGURA || p0 > p1 || p1 >= 8 ||
+        pacote->tamanho != 5 + largura * (p1 - p0 + 1)) {
+        return;
+    }
+    for (uint p = p0; p <= p1; p++) {
+        memcpy(tool->oled[porta] + p * TELEMETRIA_OLED_LARGURA + c0, d + 5 + (p - p0) * largura, largura);
+    }
+    tool->tem_oled[porta] = true;
+    if (tool->dump) {
+        fprintf(tool->dump, "oled %u %lu %u %u-%u %u-%u ", pacote->sequencia, (unsigned long)pacote->tempo_us,
+                porta, c0, c1, p0, p1);
+        dump_hex(tool->dump, d + 5, pacote->tamanho - 5);
+        fputc('\n', tool->dump);
+    }
+}
+
+static void recebe_pacote(const telemetria_pacote_t *pacote, void *contexto) {
+    telemetria_tool_t *tool = contexto;
+    if (!tool->tem_tempo) {
+        tool->primeiro_us = pacote->tempo_us;
+        tool->tem_tempo = true;
+    }
+    tool->ultimo_us = pacote->tempo_us;
+    switch (pacote->tipo) {
+    case TELEMETRIA_ESTADO:
+        recebe_estado(tool, pacote);
+        break;
+    case TELEMETRIA_LEDS:
+        recebe_leds(tool, pacote);
+        break;
+    case TELEMETRIA_OLED:
+        recebe_oled(tool, pacote);
+        break;
+    }
+}
+
+static void recebe_texto(const uint8_t *bytes, size_t tamanho, void *contexto) {
+    telemetria_tool_t *tool = contexto;
+    if (tool->texto) {
+        fwrite(bytes, 1, tamanho, stderr);
+    }
+    if (tool->dump) {
+        fputs("texto ", tool->dump);
+        for (size_t i = 0; i < tamanho; i++) {
+            fputc(bytes[i] == '\n' || bytes[i] == '\r' ? ' ' : bytes[i], tool->dump);
+        }
+        fputc('\n', tool->dump);
+    }
+}
+
+// Conteúdo final de um display, no formato do DINO_HOST_DUMP
+static void dump_oled_final(telemetria_tool_t *tool, uint porta) {
+    fprintf(tool->dump, "oled-final %u\n", porta);
+    for (uint y = 0; y < 64; y++) {
+        for (uint x = 0; x < TELEMETRIA_OLED_LARGURA; x++) {
+            uint8_t byte = tool->oled[porta][(y / 8) * TELEMETRIA_OLED_LARGURA + x];
+            fputc(byte & (1 << (y % 8)) ? '#' : '.', tool->dump);
+        }
+        fputc('\n', tool->dump);
+    }
+}
+
+int main(int argc, char **argv) {
+    static telemetria_tool_t tool;
+    const char *dump_path = NULL;
+    tool.porta_tela = HAL_I2C1;
+
+    int arg = 1;
+    while (arg < argc && strncmp(argv[arg], "--", 2) == 0) {
+        if (strcmp(argv[arg], "--tela") == 0) {
+            tool.tela = true;
+        } else if (strcmp(argv[arg], "--tempo-real") == 0) {
+            tool.tempo_real = true;
+        } else if (strcmp(argv[arg], "--texto") == 0) {
+            tool.texto = true;
+        } else if (strcmp(argv[arg], "--dump") == 0 && arg + 1 < argc) {
+            dump_path = argv[++arg];
+        } else if (strcmp(argv[arg], "--porta") == 0 && arg + 1 < argc) {
+            tool.porta_tela = (uint)atoi(argv[++arg]) % TELEMETRIA_TOOL_PORTAS;
+        } else {
+            break;
+        }
+        arg++;
+    }
+    if (arg != argc - 1) {
+        fprintf(stderr, "uso: %s [--tela] [--tempo-real] [--porta n] [--texto] [--dump saida.txt] entrada|-\n",
+                argv[0]);
+        return 1;
+    }
+
+    FILE *entrada = strcmp(argv[arg], "-") == 0 ? stdin : fopen(argv[arg], "rb");
+    if (!entrada) {
+        fprintf(stderr, "dino_telemetria: não foi possível abrir %s\n", argv[arg]);
+        return 1;
+    }
+    if (dump_path) {
+        tool.dump = fopen(dump_path, "w");
+        if (!tool.dump) {
+            fprintf(stderr, "dino_telemetria: não foi possível criar %s\n", dump_path);
+            return 1;
+        }
+    }
+    if (tool.tela) {
+        printf("\x1b[2J");
+    }
+
+    telemetria_decodificador_init(&tool.decodificador, recebe_pacote, recebe_texto, &tool);
+    uint8_t bytes[4096];
+    size_t n;
+    while ((n = fread(bytes, 1, sizeof(bytes), entrada)) > 0) {
+        telemetria_decodifica(&tool.decodificador, bytes, n);
+        tool.bytes_lidos += n;
+    }
+    telemetria_decodifica_fim(&tool.decodificador);
+
+    if (tool.dump) {
+        for (uint porta = 0; porta < TELEMETRIA_TOOL_PORTAS; porta++) {
+            if (tool.tem_oled[porta]) {
+                dump_oled_final(&tool, porta);
+            }
+        }
+        fclose(tool.dump);
+    }
+
+    const telemetria_decodificador_t *d = &tool.decodificador;
+    fprintf(stderr, "dino_telemetria: %lu pacotes, %lu inválidos, %lu perdidos, %llu bytes de texto\n",
+            (unsigned long)d->pacotes, (unsigned long)d->invalidos, (unsigned long)d->perdidos,
+            (unsigned long long)d->texto_bytes);
+    // O tempo é o de quando cada pacote foi enfileirado na placa: com a fila
+    // sem perdas, é a vazão que a serial sustentou
+    uint32_t duracao_us = tool.ultimo_us - tool.primeiro_us;
+    if (duracao_us > 0) {
+        fprintf(stderr, "dino_telemetria: %llu bytes em %.3f s (%.1f KB/s)\n", (unsigned long long)tool.bytes_lidos,
+                duracao_us / 1e6, tool.bytes_lidos * 1e6 / duracao_us / 1024.0);
+    }
+    return 0;
+}